@@ -7,12 +7,43 @@
 #include <numeric>
 #include <tuple>
 #include <chrono>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <limits>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <functional>
+#include <string>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+#include <charconv>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#if (defined(__x86_64__) || defined(__i386__)) && !defined(_MSC_VER)
+#include <x86intrin.h>
+#endif
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 //-------------------------------
 // Estructuras básicas
 //-------------------------------
 struct Maquina {
     int id;
     int tiempo_ocupado = 0;
+    int velocidad = 100; // en %: una tarea de duración p tarda ceil(p·100 / velocidad) (Q||Cmax)
 
 
     // Necesario para comparar Estados en std::map
@@ -44,10 +75,45 @@ struct Asignacion {
     int posicion;
 };
 
+/*
+  Tiempos de proceso tarea × máquina (R||Cmax), fila a fila: la fila de una
+  tarea son sus tiempos en todas las máquinas, contiguos, que es lo que
+  recorre la ramificación. Cada fila empieza en una línea de caché (64 B).
+  En 'Estado::tiempos' las filas se indexan por id de tarea y las columnas
+  por posición en 'Estado::M'.
+ */
+struct MatrizTiempos {
+    struct alignas(64) LineaCache {
+        int v[16];
+    };
+    static constexpr int POR_LINEA = 16;
+
+    int num_filas = 0;
+    int num_columnas = 0;
+    int paso = 0; // enteros por fila: num_columnas redondeado a POR_LINEA
+    std::vector<LineaCache> lineas;
+
+    MatrizTiempos() = default;
+    MatrizTiempos(int filas, int columnas)
+        : num_filas(filas), num_columnas(columnas), paso((columnas + POR_LINEA - 1) / POR_LINEA * POR_LINEA),
+          lineas(static_cast<std::size_t>(filas) * (paso / POR_LINEA), LineaCache{}) {}
+
+    int* fila(int i) {
+        return lineas[static_cast<std::size_t>(i) * (paso / POR_LINEA)].v;
+    }
+    const int* fila(int i) const {
+        return lineas[static_cast<std::size_t>(i) * (paso / POR_LINEA)].v;
+    }
+    int operator()(int i, int j) const { return fila(i)[j]; }
+};
+
 struct Estado {
     std::vector<Maquina> M;
     std::vector<Tarea> T;
     std::vector<Asignacion> Asignaciones;
+    // Opcional. Si no es nulo, el tiempo de cada tarea en cada máquina sale de
+    // aquí (ver 'duracionEn'); se comparte entre todos los estados de una búsqueda.
+    std::shared_ptr<const MatrizTiempos> tiempos;
 
     // Necesario para usar Estado como clave en std::map.
     // Comparamos los vectores M y T.
@@ -62,6 +128,41 @@ struct Estado {
     }
 };
 
+//--------------------------------
+// Modelo de máquinas
+//--------------------------------
+/*
+  - Identicas (P||Cmax): toda tarea tarda 'Tarea::tiempo' en cualquier máquina.
+  - Uniformes (Q||Cmax): alguna máquina tiene 'velocidad' distinta de 100.
+  - NoRelacionadas (R||Cmax): el estado tiene matriz de tiempos.
+  Los motores compactos (A*, IDA*, HDA*, programación dinámica...) se apoyan
+  en que las máquinas son intercambiables; con otro modelo 'compactarEstado'
+  falla y caen en 'A_estrella_general', salvo 'ramificacionYPoda', que tiene
+  una versión para cada modelo (ver 'ramificacionYPodaModelo').
+ */
+enum class ModeloMaquinas { Identicas, Uniformes, NoRelacionadas };
+
+ModeloMaquinas modeloMaquinas(const Estado& estado) {
+    if (estado.tiempos) return ModeloMaquinas::NoRelacionadas;
+    for (const Maquina& m : estado.M)
+        if (m.velocidad != 100) return ModeloMaquinas::Uniformes;
+    return ModeloMaquinas::Identicas;
+}
+
+// Tiempo que tarda 'tarea' en la máquina de posición j de 'estado.M'.
+inline int duracionEn(const Estado& estado, const Tarea& tarea, std::size_t j) {
+    if (estado.tiempos) return (*estado.tiempos)(tarea.id, static_cast<int>(j));
+    const int v = estado.M[j].velocidad;
+    return v == 100 ? tarea.tiempo : (tarea.tiempo * 100 + v - 1) / v;
+}
+
+// Menor tiempo de 'tarea' en cualquier máquina.
+inline int duracionMinima(const Estado& estado, const Tarea& tarea) {
+    int minima = std::numeric_limits<int>::max();
+    for (std::size_t j = 0; j < estado.M.size(); ++j) minima = std::min(minima, duracionEn(estado, tarea, j));
+    return estado.M.empty() ? tarea.tiempo : minima;
+}
+
 //--------------------------------
 // Función de asignación
 //--------------------------------
@@ -93,6 +194,8 @@ Estado asignarTarea(const Estado& estado, int tarea_id, int maquina_id) {
 
     // 7. Obtenemos una REFERENCIA (&) a la máquina encontrada.
     Maquina& maquina = *it_maquina;
+    // 8. Lo que tarda la tarea en esa máquina (ver "Modelo de máquinas").
+    int duracion = duracionEn(nuevo, tarea, static_cast<std::size_t>(it_maquina - nuevo.M.begin()));
 
 
 
@@ -105,7 +208,7 @@ Estado asignarTarea(const Estado& estado, int tarea_id, int maquina_id) {
     // 11. Actualizamos el tiempo de la máquina en el nuevo estado.
     //     Como 'maquina' es una referencia (ver paso 7), esto modifica
     //     directamente la máquina que está DENTRO de 'nuevo.M'.
-    maquina.tiempo_ocupado += tarea.tiempo;
+    maquina.tiempo_ocupado += duracion;
     // 12. Devolvemos el estado 'nuevo' ya modificado.
     return nuevo;
 }
@@ -132,9 +235,10 @@ int calcularHeuristica2(const Estado& estado) {
     int M = estado.M.size();
 
     // 1. Calcula la suma total del tiempo de procesamiento de todas las tareas pendientes.
-    // (Esto es: Σ T_restantes)
+    // (Esto es: Σ T_restantes). Con máquinas no idénticas cada tarea cuenta
+    // lo que tarda en su máquina más rápida, así que la cota sigue siendo admisible.
     int suma_t_restantes = 0;
-    for (const auto& t : estado.T) suma_t_restantes += t.tiempo;
+    for (const auto& t : estado.T) suma_t_restantes += duracionMinima(estado, t);
 
     // 2. Calcula el makespan actual (C_actual), que es el tiempo de la máquina más cargada.
     int tiempo_max = 0;
@@ -143,25 +247,279 @@ int calcularHeuristica2(const Estado& estado) {
     // 3. Calcula el "espacio libre total" en el sistema.
     // Para cada máquina, calcula cuánto tiempo le falta para alcanzar el makespan actual
     // y suma todas esas diferencias. (Esto es: Σ (C_actual - L_j))
-    double suma_espacio_libre = 0.0;
+    int suma_espacio_libre = 0;
     for (const auto& m : estado.M) suma_espacio_libre += (tiempo_max - m.tiempo_ocupado);
 
-    // 4. Calcula el "espacio libre promedio" dividiendo el total por el número de máquinas.
-    double espacio_libre_promedio = suma_espacio_libre / M;
+    // 4. Calcula la heurística en aritmética entera:
+    // ceil((Σ T_restantes - Σ espacio libre) / M). Es admisible: g + h vale
+    // ceil((Σ L_j + Σ T_restantes) / M), y ningún makespan (entero) puede ser
+    // menor que la carga media. Con 'double' y std::round el resultado dependía
+    // del redondeo.
+    int exceso = suma_t_restantes - suma_espacio_libre;
 
-    // 5. Calcula la heurística:
-    // (Carga promedio restante por máquina) - (Espacio libre promedio disponible)
-    double heuristica = (static_cast<double>(suma_t_restantes)/M) - espacio_libre_promedio;
-
-    // 6. Si la carga promedio es menor que el espacio libre, estimamos 0 coste adicional.
-    if (heuristica < 0) heuristica = 0;
-    return static_cast<int>(std::round(heuristica));
+    // 5. Si la carga restante cabe en el espacio libre, estimamos 0 coste adicional.
+    if (exceso <= 0) return 0;
+    return (exceso + M - 1) / M;
     //return 0;
 }
+//--------------------------------
+// Perfilado por fases
+//--------------------------------
+/*
+  Temporizadores de ámbito para ver en qué se va el tiempo dentro de una
+  expansión. 'MEDIR_FASE(fase)' mide desde ese punto hasta el final del
+  bloque y lo suma al perfil del hilo que lo ejecuta: cada hilo escribe solo
+  en el suyo, sin atómicos ni bloqueos. Las fases se anidan ('Evaluacion',
+  el f de cada hijo, cae dentro de 'Sucesores'), así que sus tiempos no se
+  suman entre sí.
+  El reloj es el contador de ciclos (rdtsc) en x86 y steady_clock en el
+  resto; los ciclos se pasan a tiempo comparando ambos relojes entre el
+  primer perfil y el informe.
+  Con 'activarTraza' cada medición se guarda también como evento (hasta
+  MAX_EVENTOS_TRAZA por hilo, más las fases de una vez por búsqueda) y 'trazaChrome' los devuelve en el formato de
+  eventos de traza de Chrome, que abren Perfetto y chrome://tracing.
+  Solo se compila con -DPERFIL_FASES=1; por defecto 'MEDIR_FASE' no genera
+  código y el informe y la traza salen vacíos.
+ */
+#ifndef PERFIL_FASES
+#define PERFIL_FASES 0
+#endif
+
+enum class Fase {
+    Busqueda,        // 'A_estrella' entero
+    Preparacion,     // 'prepararBusqueda': compactación y cotas de la raíz
+    ExtraerAbierta,  // pop de la lista abierta
+    Sucesores,       // generación de los hijos de un nodo
+    Evaluacion,      // g y cota inferior de un hijo
+    Cerrada,         // consulta e inserción en la lista cerrada
+    InsertarAbierta, // push en la lista abierta
+    Reconstruccion,  // de la meta (o el incumbente) a un 'Estado'
+    NUM_FASES
+};
+constexpr int NUM_FASES = static_cast<int>(Fase::NUM_FASES);
+constexpr const char* NOMBRES_FASE[NUM_FASES] = {"Busqueda", "Preparacion", "ExtraerAbierta", "Sucesores",
+                                                 "Evaluacion", "Cerrada", "InsertarAbierta", "Reconstruccion"};
+
+#if PERFIL_FASES
+constexpr std::size_t MAX_EVENTOS_TRAZA = std::size_t{1} << 20; // 24 MiB por hilo
+
+inline std::uint64_t relojFase() {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    return __rdtsc();
+#else
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+struct EventoTraza {
+    std::uint64_t inicio;
+    std::uint64_t duracion;
+    Fase fase;
+};
+
+struct PerfilHilo {
+    int hilo = 0;
+    std::array<std::uint64_t, NUM_FASES> ticks{};
+    std::array<long long, NUM_FASES> llamadas{};
+    std::vector<EventoTraza> eventos;
+    long long eventos_perdidos = 0; // por encima de MAX_EVENTOS_TRAZA
+};
+
+// Perfiles de todos los hilos que han medido algo. Duran hasta el final del
+// programa: los hilos de los motores paralelos terminan antes del informe.
+struct RegistroPerfiles {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<PerfilHilo>> perfiles;
+    std::atomic<bool> trazar{false};
+    const std::uint64_t origen = relojFase();
+    const std::chrono::steady_clock::time_point origen_reloj = std::chrono::steady_clock::now();
+
+    static RegistroPerfiles& global() {
+        static RegistroPerfiles registro;
+        return registro;
+    }
+
+    PerfilHilo& nuevoPerfil() {
+        std::lock_guard<std::mutex> lock(mutex);
+        perfiles.emplace_back(new PerfilHilo);
+        perfiles.back()->hilo = static_cast<int>(perfiles.size()) - 1;
+        return *perfiles.back();
+    }
+
+    // Ticks de 'relojFase' por microsegundo.
+    double ticksPorMicrosegundo() const {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+        double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - origen_reloj).count();
+        return us > 0 ? static_cast<double>(relojFase() - origen) / us : 1.0;
+#else
+        return 1000.0;
+#endif
+    }
+};
+
+inline PerfilHilo& perfilDelHilo() {
+    thread_local PerfilHilo* perfil = nullptr;
+    if (!perfil) perfil = &RegistroPerfiles::global().nuevoPerfil();
+    return *perfil;
+}
+
+struct TemporizadorFase {
+    PerfilHilo& perfil; // se obtiene antes de leer el reloj: el primer uso no se mide
+    const Fase fase;
+    const std::uint64_t inicio;
+
+    explicit TemporizadorFase(Fase fase_) : perfil(perfilDelHilo()), fase(fase_), inicio(relojFase()) {}
+    ~TemporizadorFase() {
+        std::uint64_t duracion = relojFase() - inicio;
+        perfil.ticks[static_cast<int>(fase)] += duracion;
+        ++perfil.llamadas[static_cast<int>(fase)];
+        if (!RegistroPerfiles::global().trazar.load(std::memory_order_relaxed)) return;
+        // Las fases de una vez por búsqueda se guardan siempre: son las que
+        // terminan después de llenarse la traza y las que la enmarcan.
+        bool unica = fase == Fase::Busqueda || fase == Fase::Preparacion || fase == Fase::Reconstruccion;
+        if (perfil.eventos.size() < MAX_EVENTOS_TRAZA || unica) perfil.eventos.push_back({inicio, duracion, fase});
+        else ++perfil.eventos_perdidos;
+    }
+    TemporizadorFase(const TemporizadorFase&) = delete;
+    TemporizadorFase& operator=(const TemporizadorFase&) = delete;
+};
+
+#define CONCATENAR_FASE_(a, b) a##b
+#define CONCATENAR_FASE(a, b) CONCATENAR_FASE_(a, b)
+#define MEDIR_FASE(fase) TemporizadorFase CONCATENAR_FASE(temporizador_fase_, __LINE__)(fase)
+#else
+#define MEDIR_FASE(fase) ((void)0)
+#endif
+
+// Empieza o deja de guardar eventos para 'trazaChrome'.
+inline void activarTraza([[maybe_unused]] bool activa) {
+#if PERFIL_FASES
+    RegistroPerfiles::global().trazar.store(activa);
+#endif
+}
+
+// Pone a cero tiempos y eventos de todos los hilos. Solo sin búsquedas en curso.
+inline void reiniciarPerfil() {
+#if PERFIL_FASES
+    RegistroPerfiles& registro = RegistroPerfiles::global();
+    std::lock_guard<std::mutex> lock(registro.mutex);
+    for (auto& perfil : registro.perfiles) {
+        perfil->ticks.fill(0);
+        perfil->llamadas.fill(0);
+        perfil->eventos.clear();
+        perfil->eventos_perdidos = 0;
+    }
+#endif
+}
+
+// Una línea por hilo y fase medida: llamadas, tiempo total y tiempo por llamada.
+inline void imprimirPerfil([[maybe_unused]] std::ostream& os) {
+#if PERFIL_FASES
+    RegistroPerfiles& registro = RegistroPerfiles::global();
+    std::lock_guard<std::mutex> lock(registro.mutex);
+    const double ticks_us = registro.ticksPorMicrosegundo();
+    char linea[128];
+    os << "Perfil por fases (hilo, fase, llamadas, ms, ns por llamada):\n";
+    for (const auto& perfil : registro.perfiles) {
+        for (int f = 0; f < NUM_FASES; ++f) {
+            if (!perfil->llamadas[f]) continue;
+            double us = static_cast<double>(perfil->ticks[f]) / ticks_us;
+            std::snprintf(linea, sizeof(linea), "  %3d %-16s %12lld %12.3f %10.1f\n", perfil->hilo, NOMBRES_FASE[f],
+                          perfil->llamadas[f], us / 1000.0, 1000.0 * us / static_cast<double>(perfil->llamadas[f]));
+            os << linea;
+        }
+        if (perfil->eventos_perdidos)
+            os << "  " << perfil->hilo << ": " << perfil->eventos_perdidos << " eventos fuera de la traza\n";
+    }
+#endif
+}
+
+// Eventos guardados desde 'activarTraza', en el formato JSON de eventos de traza
+// de Chrome: un evento completo ("ph":"X") por medición, en microsegundos.
+inline std::string trazaChrome() {
+    std::string json = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+#if PERFIL_FASES
+    RegistroPerfiles& registro = RegistroPerfiles::global();
+    std::lock_guard<std::mutex> lock(registro.mutex);
+    const double ticks_us = registro.ticksPorMicrosegundo();
+    char evento[160];
+    bool primero = true;
+    for (const auto& perfil : registro.perfiles) {
+        std::snprintf(evento, sizeof(evento),
+                      "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"hilo %d\"}}",
+                      primero ? "" : ",", perfil->hilo, perfil->hilo);
+        json += evento;
+        primero = false;
+        for (const EventoTraza& e : perfil->eventos) {
+            std::snprintf(evento, sizeof(evento),
+                          ",{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                          NOMBRES_FASE[static_cast<int>(e.fase)], perfil->hilo,
+                          static_cast<double>(e.inicio - registro.origen) / ticks_us,
+                          static_cast<double>(e.duracion) / ticks_us);
+            json += evento;
+        }
+    }
+#endif
+    return json + "]}";
+}
+
 //--------------------------------
 // Generar sucesores
 //--------------------------------
+/*
+  Recorre los sucesores de 'estado' sin construirlos. Para cada par (tarea,
+  máquina), en el mismo orden que 'generarSucesores', llama a
+  visitar(i, j, g, h) con i y j los índices en 'estado.T' y 'estado.M' y los
+  costes del hijo, que se calculan en O(1): g es el máximo entre el g del
+  padre y la nueva carga de la máquina, y 'calcularHeuristica2' del hijo vale
+  ceil((carga total - M·g) / M) si es positivo, porque la carga total
+  (asignada más pendiente) no cambia al asignar. Con máquinas no idénticas
+  la carga pendiente cuenta la duración mínima de cada tarea, y al asignar
+  la carga total cambia en (duración en la máquina - duración mínima).
+  El visitante decide si construye el hijo con 'construirSucesor'.
+ */
+template <typename Visitante>
+void recorrerSucesores(const Estado& estado, Visitante&& visitar) {
+    MEDIR_FASE(Fase::Sucesores);
+    const long long M = static_cast<long long>(estado.M.size());
+    const bool identicas = modeloMaquinas(estado) == ModeloMaquinas::Identicas;
+    const int g = calcularCoste(estado);
+    long long total = 0;
+    for (const auto& m : estado.M) total += m.tiempo_ocupado;
+    for (const auto& t : estado.T) total += identicas ? t.tiempo : duracionMinima(estado, t);
+
+    for (std::size_t i = 0; i < estado.T.size(); ++i) {
+        const int minima = identicas ? estado.T[i].tiempo : duracionMinima(estado, estado.T[i]);
+        for (std::size_t j = 0; j < estado.M.size(); ++j) {
+            const int d = identicas ? estado.T[i].tiempo : duracionEn(estado, estado.T[i], j);
+            int g_hijo = std::max(g, estado.M[j].tiempo_ocupado + d);
+            long long exceso = total - minima + d - M * g_hijo;
+            int h_hijo = exceso <= 0 ? 0 : static_cast<int>((exceso + M - 1) / M);
+            visitar(i, j, g_hijo, h_hijo);
+        }
+    }
+}
+
+// Equivalente a 'asignarTarea' con la tarea y la máquina dadas por su índice
+// en 'estado.T' y 'estado.M': copia cada vector una sola vez y sin búsquedas.
+Estado construirSucesor(const Estado& estado, std::size_t i, std::size_t j) {
+    Estado hijo;
+    hijo.M = estado.M;
+    hijo.M[j].tiempo_ocupado += duracionEn(estado, estado.T[i], j);
+    hijo.tiempos = estado.tiempos;
+    hijo.T.reserve(estado.T.size() - 1);
+    hijo.T.insert(hijo.T.end(), estado.T.begin(), estado.T.begin() + i);
+    hijo.T.insert(hijo.T.end(), estado.T.begin() + i + 1, estado.T.end());
+    hijo.Asignaciones.reserve(estado.Asignaciones.size() + 1);
+    hijo.Asignaciones.insert(hijo.Asignaciones.end(), estado.Asignaciones.begin(), estado.Asignaciones.end());
+    hijo.Asignaciones.push_back({estado.T[i].id, estado.M[j].id, 0});
+    return hijo;
+}
+
+// Todos los sucesores construidos. Para la búsqueda se usa 'recorrerSucesores'.
 std::vector<Estado> generarSucesores(const Estado& estado) {
+    MEDIR_FASE(Fase::Sucesores);
 
     // 1. Se crea un vector vacío para almacenar los estados hijos que se generen.
     std::vector<Estado> sucesores;
@@ -196,9 +554,14 @@ struct Nodo {
 };
 
 //--------------------------------
-// Algoritmo de Búsqueda: A*
+// Algoritmo de Búsqueda: A* (versión general con vectores)
 //--------------------------------
-Estado A_estrella(const Estado& estado_inicial) {
+/*
+  Versión original de A* que trabaja directamente sobre 'Estado'.
+  Se mantiene para instancias que no caben en la codificación compacta
+  (más de MAX_MAQUINAS máquinas o más de MAX_TAREAS tareas).
+ */
+Estado A_estrella_general(const Estado& estado_inicial) {
 
     // --- LÍNEA 1: 'open' es una min-heap ---
     // Declara la 'cola' (Lista Abierta) como una cola de prioridad mínima (min-heap).
@@ -223,8 +586,9 @@ Estado A_estrella(const Estado& estado_inicial) {
     while (!cola.empty()) {
 
         // --- n <- pop(open) ---
-        // Obtiene una copia del nodo con el MENOR f_cost (el mejor candidato).
-        Nodo actual = cola.top();
+        // Saca el nodo con el MENOR f_cost (el mejor candidato). Se mueve en
+        // lugar de copiarse: 'pop' solo compara f_cost, que sigue intacto.
+        Nodo actual = std::move(const_cast<Nodo&>(cola.top()));
         // Elimina ese nodo de la cola para procesarlo.
         cola.pop();
 
@@ -249,14 +613,13 @@ Estado A_estrella(const Estado& estado_inicial) {
             closed_list[actual.estado] = actual.g_cost;
 
             // --- Generar y añadir hijos ---
-            for (auto& sucesor : generarSucesores(actual.estado)) {
-                int g_sucesor = calcularCoste(sucesor);
-                int h_sucesor = calcularHeuristica2(sucesor);
-
+            // Cada hijo se puntúa sin construirlo y se construye directamente
+            // dentro del Nodo que entra en la cola.
+            recorrerSucesores(actual.estado, [&](std::size_t i, std::size_t j, int g_sucesor, int h_sucesor) {
                 // Añadimos el sucesor a la cola 'open' para ser procesado
                 // La cola de prioridad lo ordenará automáticamente según su f_cost.
-                cola.push({sucesor, g_sucesor, g_sucesor + h_sucesor});
-            }
+                cola.push({construirSucesor(actual.estado, i, j), g_sucesor, g_sucesor + h_sucesor});
+            });
         }
 
     }
@@ -268,72 +631,5036 @@ Estado A_estrella(const Estado& estado_inicial) {
 }
 
 //--------------------------------
-// Programa principal
+// Codificación compacta del estado
 //--------------------------------
-int main() {
-    Estado estado;
-    int N = 4 ; // EDITAR SI SE QUIERE CAMBIAR EL NUMERO DE MÁQUINAS
-    for (int i = 1; i <= N; i++) {
-        estado.M.push_back({i});
+// Límites de la codificación compacta. Con ellos un EstadoCompacto ocupa
+// 80 bytes (dos líneas de caché) y se copia sin reservar memoria dinámica.
+constexpr int MAX_MAQUINAS = 16;
+constexpr int MAX_TAREAS = 128;
+constexpr int PALABRAS_TAREAS = MAX_TAREAS / 64;
+
+// Datos fijos del problema, compartidos por todos los estados compactos.
+// Dentro de la búsqueda las tareas se identifican por su índice y las
+// máquinas por su posición en el vector ordenado de cargas; los ids
+// originales solo se recuperan al reconstruir la solución.
+struct Instancia {
+    int num_maquinas = 0;
+    int num_tareas = 0;
+    std::vector<int> tiempos;    // tiempos[i] = duración de la tarea de índice i
+    std::vector<int> id_tarea;   // índice -> id de la tarea en el Estado original
+    std::vector<int> id_maquina; // posición inicial -> id de la máquina en el Estado original
+    std::vector<int> anterior_igual; // índice de la tarea previa con la misma duración, o -1
+    std::vector<std::uint64_t> zobrist_tarea; // clave Zobrist de cada tarea (ver 'EstadoCompacto::clave')
+    bool tiempos_decrecientes = false; // tareas numeradas en orden LPT (ver 'OrdenTareas')
+    int carga_total = 0;               // Σ cargas iniciales + Σ tiempos: constante en toda la búsqueda
+    int cota_raiz = 0;                 // cota inferior del óptimo calculada una vez (ver 'cotaRaiz')
+};
+
+//--------------------------------
+// Opciones de búsqueda
+//--------------------------------
+// Orden en que se numeran (y, con OrdenFijo, se asignan) las tareas.
+enum class OrdenTareas {
+    DuracionDecreciente, // orden LPT: primero las tareas más largas
+    Entrada              // el orden en que aparecen en 'Estado::T'
+};
+
+enum class Ramificacion {
+    OrdenFijo,     // se asigna siempre la siguiente tarea del orden: ramifica solo en la máquina
+    TodasLasTareas // ramifica en cada par (tarea pendiente, máquina), como 'generarSucesores'
+};
+
+// Cota inferior usada para f (ver "Cotas inferiores admisibles").
+enum class CotaInferior { Heuristica2, L1, L2, Automatica };
+
+//--------------------------------
+// Estadísticas de búsqueda
+//--------------------------------
+/*
+  Contadores que rellenan los motores cuando 'OpcionesBusqueda::estadisticas'
+  apunta a una estructura; al terminar la búsqueda se sobrescribe con los de
+  esa búsqueda. Los campos que no tienen sentido para un motor quedan a 0.
+  Compilando con -DESTADISTICAS_BUSQUEDA=0, cada 'CONTAR(...)' desaparece y
+  los motores no cuentan ni miden nada.
+ */
+#ifndef ESTADISTICAS_BUSQUEDA
+#define ESTADISTICAS_BUSQUEDA 1
+#endif
+#if ESTADISTICAS_BUSQUEDA
+#define CONTAR(expr) (expr)
+#else
+#define CONTAR(expr) ((void)0)
+#endif
+
+// Memoria de un hilo de un motor paralelo, por estructura propia del hilo.
+struct MemoriaHilo {
+    std::size_t arena = 0;   // bloques de nodos
+    std::size_t tabla = 0;   // su parte de la lista cerrada
+    std::size_t abierta = 0; // sus cubetas
+    std::size_t bufer = 0;   // mensajes (HDA*) o sucesores (A* por lotes)
+
+    std::size_t total() const { return arena + tabla + abierta + bufer; }
+};
+
+struct EstadisticasBusqueda {
+    long long expandidos = 0;     // nodos expandidos
+    long long generados = 0;      // sucesores generados (tras la poda por cota y simetría)
+    long long duplicados = 0;     // sucesores que ya estaban en la lista cerrada (aciertos)
+    long long reaperturas = 0;    // duplicados que mejoran el g de un nodo ya cerrado
+    std::size_t pico_abierta = 0; // máximo de entradas en la lista abierta
+    std::size_t bytes = 0;        // memoria reservada por las estructuras de búsqueda
+    double segundos = 0;
+    std::vector<MemoriaHilo> memoria_hilos; // motores paralelos: desglose de 'bytes' por hilo
+
+    double nodosPorSegundo() const { return segundos > 0 ? expandidos / segundos : 0; }
+
+    // Suma los contadores de otro hilo. El pico resultante es la suma de los
+    // picos de cada hilo, una cota superior del pico conjunto.
+    void acumular(const EstadisticasBusqueda& otra) {
+        expandidos += otra.expandidos;
+        generados += otra.generados;
+        duplicados += otra.duplicados;
+        reaperturas += otra.reaperturas;
+        pico_abierta += otra.pico_abierta;
+        bytes += otra.bytes;
     }
 
-    // EDITAR SI SE QUIERE CAMBIAR EL LISTADO DE TAREAS A ASIGNAR
-    std::vector<int> tiempos = {25, 22, 19, 17, 12, 12, 11, 10, 10, 9, 9, 8, 8, 7, 5, 5, 5, 5, 4, 4, 4, 4, 3, 3, 3, 3, 2, 2, 2, 2, 1, 1, 1, 1};
-  //std::vector<int> tiempos = {25, 22, 19, 17, 12, 12, 11, 10, 10, 9, 9, 8, 8, 7, 5, 5, 5, 5, 4, 4, 4, 4, 3, 3, 3, 3, 2, 2, 2, 2, 1, 1, 1, 1, 2, 2, 3, 2, 5, 4, 5}; // DESCOMENTAR SI SE QUIERE PROBAR ESTE EJEMPLO
+    void imprimir(std::ostream& os) const {
+        os << "Nodos expandidos:        " << expandidos << "\n"
+           << "Nodos generados:         " << generados << "\n"
+           << "Duplicados (cerrada):    " << duplicados << "\n"
+           << "Reaperturas:             " << reaperturas << "\n"
+           << "Pico de la lista abierta: " << pico_abierta << "\n"
+           << "Memoria reservada (B):   " << bytes << "\n"
+           << "Nodos por segundo:       " << nodosPorSegundo() << "\n";
+        for (std::size_t h = 0; h < memoria_hilos.size(); ++h) {
+            const MemoriaHilo& m = memoria_hilos[h];
+            os << "  Hilo " << h << " (B): arena " << m.arena << ", tabla " << m.tabla << ", abierta " << m.abierta
+               << ", bufer " << m.bufer << ", total " << m.total() << "\n";
+        }
+    }
 
-    for (int i = 0; i < (int)tiempos.size(); ++i) {
-        estado.T.push_back({i + 1, tiempos[i]});
+    std::string json() const {
+        return "{\"expandidos\":" + std::to_string(expandidos) + ",\"generados\":" + std::to_string(generados) +
+               ",\"duplicados\":" + std::to_string(duplicados) + ",\"reaperturas\":" + std::to_string(reaperturas) +
+               ",\"pico_abierta\":" + std::to_string(pico_abierta) + ",\"bytes\":" + std::to_string(bytes) +
+               ",\"segundos\":" + std::to_string(segundos) + ",\"nodos_por_segundo\":" +
+               std::to_string(nodosPorSegundo()) + ",\"memoria_hilos\":[" + jsonMemoriaHilos() + "]}";
     }
 
-    // SE EJECUTA EL ALGORITMO DE BÚSQUEDA
-    auto start = std::chrono::steady_clock::now();
-    Estado solucion = A_estrella(estado);
-    auto end = std::chrono::steady_clock::now();
+    std::string jsonMemoriaHilos() const {
+        std::string s;
+        for (const MemoriaHilo& m : memoria_hilos)
+            s += std::string(s.empty() ? "" : ",") + "{\"arena\":" + std::to_string(m.arena) +
+                 ",\"tabla\":" + std::to_string(m.tabla) + ",\"abierta\":" + std::to_string(m.abierta) +
+                 ",\"bufer\":" + std::to_string(m.bufer) + "}";
+        return s;
+    }
+};
 
+// Contadores de una búsqueda en curso. Al destruirse (en cualquier 'return'
+// del motor) anota el tiempo y copia los contadores al destino.
+struct MedicionBusqueda {
+    EstadisticasBusqueda datos;
+#if ESTADISTICAS_BUSQUEDA
+    EstadisticasBusqueda* destino;
+    std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
 
-    //----------------Presntación de los resultaods----------------
-    std::cout << "Asignaciones finales:\n";
-    for (const auto& a : solucion.Asignaciones)
-        std::cout << "Tarea " << a.tarea_id << " -> Maquina " << a.maquina_id<< "\n";
+    explicit MedicionBusqueda(EstadisticasBusqueda* destino_) : destino(destino_) {}
+    ~MedicionBusqueda() {
+        if (!destino) return;
+        datos.segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+        *destino = datos;
+    }
+#else
+    explicit MedicionBusqueda(EstadisticasBusqueda*) {}
+#endif
+    MedicionBusqueda(const MedicionBusqueda&) = delete;
+    MedicionBusqueda& operator=(const MedicionBusqueda&) = delete;
+};
 
+// Motor exacto que usa 'resolver'.
+enum class Motor {
+    Automatico,          // se elige por instancia en 'elegirMotor'
+    AEstrella,           // 'A_estrella'
+    IDAEstrella,         // 'IDA_estrella'
+    HDAEstrella,         // 'HDA_estrella'
+    AEstrellaLotes,      // 'A_estrella_lotes'
+    ProgramacionDinamica, // 'resolverPorBinPacking'
+    RamificacionYPoda    // 'ramificacionYPoda'
+};
 
-    std::cout << "\nTiempo ocupado de maquinas:\n";
-    for (const auto& m : solucion.M)
-        std::cout << "Maquina " << m.id << ": " << m.tiempo_ocupado << "\n";
+/*
+  Estado común de una carrera de motores ('resolverCartera'): la mejor cota
+  superior (makespan de una solución encontrada) y la mejor cota inferior
+  demostrada por cualquiera de ellos. Cuando se encuentran, la solución es
+  óptima y se pide parar a todos. La parada es cooperativa: cada motor la
+  consulta cada cierto número de expansiones y devuelve lo mejor que tenga.
+  Con 'plazo' la carrera también se da por detenida al pasar ese instante
+  (así acota 'busquedaVecindarios' cada subproblema).
+ */
+struct CarreraMotores {
+    using Reloj = std::chrono::steady_clock;
 
-    std::cout << "Makespan final: " << calcularCoste(solucion) << "\n";
+    alignas(64) std::atomic<int> cota_superior{std::numeric_limits<int>::max()};
+    alignas(64) std::atomic<int> cota_inferior{0};
+    alignas(64) std::atomic<bool> parada{false};
+    Reloj::time_point plazo = Reloj::time_point::max(); // fijo antes de lanzar los motores
 
-    std::map<int, std::vector<int>> tareas_por_maquina;
-    std::map<int, std::vector<int>> tiempos_por_maquina;
+    void mejorarSuperior(int makespan) {
+        int actual = cota_superior.load(std::memory_order_relaxed);
+        while (makespan < actual && !cota_superior.compare_exchange_weak(actual, makespan)) {}
+        comprobarCierre();
+    }
+    void mejorarInferior(int cota) {
+        int actual = cota_inferior.load(std::memory_order_relaxed);
+        while (cota > actual && !cota_inferior.compare_exchange_weak(actual, cota)) {}
+        comprobarCierre();
+    }
+    void detener() { parada.store(true, std::memory_order_release); }
+    bool detenida() const {
+        return parada.load(std::memory_order_acquire) || (plazo != Reloj::time_point::max() && Reloj::now() >= plazo);
+    }
 
-    for (const auto& a : solucion.Asignaciones) {
-        int tiempo = tiempos[a.tarea_id - 1];  // Obtener el tiempo correspondiente
-        tareas_por_maquina[a.maquina_id].push_back(a.tarea_id);
-        tiempos_por_maquina[a.maquina_id].push_back(tiempo);
+private:
+    void comprobarCierre() {
+        if (cota_inferior.load() >= cota_superior.load()) detener();
     }
+};
 
-    std::cout << "\nAsignaciones por maquina:\n";
-    for (const auto& m : solucion.M) {
-        std::cout << "Maquina " << m.id << ":\n";
+struct OpcionesBusqueda {
+    Motor motor = Motor::Automatico;
+    OrdenTareas orden = OrdenTareas::DuracionDecreciente;
+    Ramificacion ramificacion = Ramificacion::OrdenFijo;
+    std::size_t memoria_cerrada = 0; // bytes para la lista cerrada (0 = sin límite)
+    std::size_t memoria_transposicion = std::size_t{16} << 20; // bytes de la tabla fija de IDA*
+    CotaInferior cota = CotaInferior::Automatica;
+    bool cota_superior = true; // calcular una solución inicial (LPT/MULTIFIT) para podar
+    int hilos = 0;             // hilos de los motores paralelos (0 = los del sistema)
+    int anchura_haz = 1024;    // estados que conserva cada capa de 'busquedaHaz'
+    int nodos_por_lote = 256;  // nodos que expande en paralelo cada paso de 'A_estrella_lotes'
+    int maquinas_vecindario = 3;    // máquinas que libera cada vecindario de 'busquedaVecindarios'
+    int tareas_vecindario = 24;     // tareas liberadas como mucho por vecindario
+    double plazo_vecindario = 0.05; // segundos por subproblema de 'busquedaVecindarios'
+    const char* directorio_externo = nullptr; // si no es nulo, A* guarda abierta y cerrada en disco aquí
+    std::size_t memoria_externa = std::size_t{256} << 20; // bytes de RAM para ordenar y mezclar en modo externo
+    std::string* error = nullptr; // si no es nulo, recibe el motivo si el motor no resuelve (E/S, instancia no admitida)
+    const Estado* solucion_previa = nullptr; // solución completa conocida: incumbente inicial (con cota_superior)
+    int cota_inferior_previa = 0;            // cota inferior del óptimo conocida de antemano
+    CarreraMotores* carrera = nullptr;       // si no es nulo, cotas compartidas y parada (ver 'resolverCartera')
+    EstadisticasBusqueda* estadisticas = nullptr; // si no es nulo, contadores de la búsqueda
+};
+
+// Número de hilos efectivo según las opciones.
+inline int hilosEfectivos(const OpcionesBusqueda& opciones) {
+    if (opciones.hilos > 0) return opciones.hilos;
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Publicación de cotas y consulta de la parada; no hacen nada fuera de una carrera.
+inline void anunciarCotaSuperior(const OpcionesBusqueda& opciones, int makespan) {
+    if (opciones.carrera) opciones.carrera->mejorarSuperior(makespan);
+}
+inline void anunciarCotaInferior(const OpcionesBusqueda& opciones, int cota) {
+    if (opciones.carrera) opciones.carrera->mejorarInferior(cota);
+}
+inline bool carreraDetenida(const OpcionesBusqueda& opciones) {
+    return opciones.carrera && opciones.carrera->detenida();
+}
+
+// Expansiones entre dos consultas de la parada de la carrera (potencia de 2).
+constexpr long long PASOS_ENTRE_CONSULTAS = 1024;
+
+/*
+  Las máquinas son idénticas, así que dos estados cuyas cargas son una
+  permutación una de otra ({10,0,0,0} y {0,10,0,0}) son equivalentes.
+  La forma canónica guarda las cargas ordenadas de mayor a menor: 'carga'
+  no dice qué máquina tiene cada carga, solo las cargas que hay. Los ids se
+  recuperan al reconstruir la solución (ver 'reconstruirEstado').
+ */
+struct EstadoCompacto {
+    std::array<int, MAX_MAQUINAS> carga{};                   // cargas en orden no creciente
+    std::array<std::uint64_t, PALABRAS_TAREAS> pendientes{}; // bit i a 1 = tarea i sin asignar
+    // Clave hash de 64 bits, mantenida de forma incremental por 'asignarTareaCompacta':
+    // suma de la clave Zobrist de cada tarea pendiente y de mezclar64(carga) de
+    // cada máquina. Al ser una suma, no depende del orden de las máquinas.
+    std::uint64_t clave = 0;
+    int restante = 0; // Σ de tiempos de las tareas pendientes
+
+    bool operator==(const EstadoCompacto& other) const {
+        return pendientes == other.pendientes && carga == other.carga;
+    }
+};
+
+// Índice del bit a 1 menos significativo (x != 0).
+inline int bitMenor(std::uint64_t x) {
+#if defined(_MSC_VER)
+    unsigned long i;
+    _BitScanForward64(&i, x);
+    return static_cast<int>(i);
+#else
+    return __builtin_ctzll(x);
+#endif
+}
+
+inline int contarBits(std::uint64_t x) {
+#if defined(_MSC_VER)
+    return static_cast<int>(__popcnt64(x));
+#else
+    return __builtin_popcountll(x);
+#endif
+}
+
+// Función de mezcla de splitmix64: reparte bien valores pequeños (cargas, ids).
+inline std::uint64_t mezclar64(std::uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+inline bool tareaPendiente(const EstadoCompacto& estado, int tarea) {
+    return (estado.pendientes[tarea >> 6] >> (tarea & 63)) & 1;
+}
+
+inline bool sinTareasPendientes(const EstadoCompacto& estado) {
+    for (std::uint64_t palabra : estado.pendientes)
+        if (palabra) return false;
+    return true;
+}
+
+inline int tareasAsignadas(const Instancia& inst, const EstadoCompacto& estado) {
+    int pendientes = 0;
+    for (std::uint64_t palabra : estado.pendientes) pendientes += contarBits(palabra);
+    return inst.num_tareas - pendientes;
+}
+
+/*
+  Traduce un 'Estado' a la codificación compacta y rellena la 'Instancia'.
+  Las tareas se numeran según 'orden'. Devuelve false si el estado no cabe
+  en los límites de la codificación o si las máquinas no son idénticas.
+ */
+bool compactarEstado(const Estado& estado, OrdenTareas orden, Instancia& inst, EstadoCompacto& compacto) {
+    if (estado.M.size() > MAX_MAQUINAS || estado.T.size() > MAX_TAREAS) return false;
+    if (modeloMaquinas(estado) != ModeloMaquinas::Identicas) return false; // las cargas no se pueden ordenar
+
+    // Se vacían los vectores en lugar de reasignar la instancia para que una
+    // 'Instancia' reutilizada (ver 'MemoriaBusqueda') conserve su memoria.
+    for (auto* v : {&inst.tiempos, &inst.id_tarea, &inst.id_maquina, &inst.anterior_igual}) v->clear();
+    inst.zobrist_tarea.clear();
+    inst.cota_raiz = 0;
+    compacto = EstadoCompacto{};
+    inst.num_maquinas = static_cast<int>(estado.M.size());
+    inst.num_tareas = static_cast<int>(estado.T.size());
+
+    // Las máquinas se guardan ya en orden canónico (carga no creciente).
+    std::vector<Maquina> maquinas = estado.M;
+    std::stable_sort(maquinas.begin(), maquinas.end(), [](const Maquina& a, const Maquina& b) {
+        return a.tiempo_ocupado > b.tiempo_ocupado;
+    });
+    for (int j = 0; j < inst.num_maquinas; ++j) {
+        inst.id_maquina.push_back(maquinas[j].id);
+        compacto.carga[j] = maquinas[j].tiempo_ocupado;
+    }
+    std::vector<Tarea> tareas = estado.T;
+    if (orden == OrdenTareas::DuracionDecreciente) {
+        std::stable_sort(tareas.begin(), tareas.end(), [](const Tarea& a, const Tarea& b) {
+            return a.tiempo > b.tiempo;
+        });
+    }
+    std::map<int, int> ultima_con_tiempo;
+    for (int i = 0; i < inst.num_tareas; ++i) {
+        inst.id_tarea.push_back(tareas[i].id);
+        inst.tiempos.push_back(tareas[i].tiempo);
+        auto it = ultima_con_tiempo.find(tareas[i].tiempo);
+        inst.anterior_igual.push_back(it == ultima_con_tiempo.end() ? -1 : it->second);
+        ultima_con_tiempo[tareas[i].tiempo] = i;
+        compacto.pendientes[i >> 6] |= std::uint64_t{1} << (i & 63);
+
+        // La clave de una tarea depende de su duración y de cuántas tareas de
+        // esa duración la preceden, no de su id: tareas intercambiables dan la
+        // misma clave y la clave es la de un multiconjunto de duraciones.
+        int rango = 0;
+        for (int a = inst.anterior_igual[i]; a >= 0; a = inst.anterior_igual[a]) ++rango;
+        inst.zobrist_tarea.push_back(mezclar64((std::uint64_t(tareas[i].tiempo) << 32) | std::uint32_t(rango)));
+        compacto.clave += inst.zobrist_tarea[i];
+        compacto.restante += tareas[i].tiempo;
+    }
+    for (int j = 0; j < inst.num_maquinas; ++j) compacto.clave += mezclar64(compacto.carga[j]);
+
+    inst.tiempos_decrecientes = std::is_sorted(inst.tiempos.begin(), inst.tiempos.end(), std::greater<int>());
+    inst.carga_total = compacto.restante;
+    for (int j = 0; j < inst.num_maquinas; ++j) inst.carga_total += compacto.carga[j];
+    return true;
+}
+
+/*
+  Suma 'tiempo' a la carga de la posición 'pos' y la desplaza hacia delante
+  hasta recuperar el orden no creciente. Devuelve la posición final; las
+  cargas entre esa posición y 'pos' se han corrido un puesto hacia atrás.
+ */
+inline int sumarCargaCanonica(int* carga, int pos, int tiempo) {
+    int valor = carga[pos] + tiempo;
+    while (pos > 0 && carga[pos - 1] < valor) {
+        carga[pos] = carga[pos - 1];
+        --pos;
+    }
+    carga[pos] = valor;
+    return pos;
+}
+
+// Equivalente compacto de 'asignarTarea': copia de 80 bytes, sin búsquedas por id.
+// 'maquina' es la posición de la máquina en el vector ordenado de cargas.
+inline EstadoCompacto asignarTareaCompacta(const Instancia& inst, const EstadoCompacto& estado,
+                                           int tarea, int maquina) {
+    EstadoCompacto nuevo = estado;
+    nuevo.pendientes[tarea >> 6] &= ~(std::uint64_t{1} << (tarea & 63));
+    int carga_anterior = estado.carga[maquina];
+    sumarCargaCanonica(nuevo.carga.data(), maquina, inst.tiempos[tarea]);
+    // Actualización O(1) de la clave: sale la tarea y cambia una carga.
+    nuevo.clave += mezclar64(carga_anterior + inst.tiempos[tarea]) - mezclar64(carga_anterior)
+                 - inst.zobrist_tarea[tarea];
+    nuevo.restante -= inst.tiempos[tarea];
+    return nuevo;
+}
+
+// g(n) sobre el estado compacto (ver 'calcularCoste'): con las cargas
+// ordenadas, el makespan actual es la primera.
+int calcularCosteCompacto(const Instancia&, const EstadoCompacto& estado) {
+    return estado.carga[0];
+}
+
+//--------------------------------
+// Especialización por número de máquinas
+//--------------------------------
+/*
+  Las funciones del bucle interno (cota inferior, ramificación, A*, IDA* y
+  el núcleo de la búsqueda en haz) son plantillas sobre MF, el número de
+  máquinas fijado en compilación; con MF = 0 se toma de 'inst.num_maquinas'
+  en ejecución. Con MF fijo el bucle de la poda por simetría tiene longitud
+  constante y se desenrolla, y la media de carga divide por una constante.
+  'despacharMaquinas' llama a 'f' con std::integral_constant<int, MF> para
+  los números de máquinas habituales (2, 3, 4, 8 y 16) y con MF = 0 para los
+  demás, de modo que quien llama mantiene una sola interfaz.
+ */
+template <typename F>
+decltype(auto) despacharMaquinas(int M, F&& f) {
+    switch (M) {
+    case 2: return f(std::integral_constant<int, 2>{});
+    case 3: return f(std::integral_constant<int, 3>{});
+    case 4: return f(std::integral_constant<int, 4>{});
+    case 8: return f(std::integral_constant<int, 8>{});
+    case 16: return f(std::integral_constant<int, 16>{});
+    default: return f(std::integral_constant<int, 0>{});
+    }
+}
+
+// Número de máquinas de una función especializada en MF.
+template <int MF>
+inline int numeroMaquinas(const Instancia& inst) {
+    static_assert(MF >= 0 && MF <= MAX_MAQUINAS, "MF fuera de la codificación compacta");
+    return MF > 0 ? MF : inst.num_maquinas;
+}
+
+//--------------------------------
+// Cotas inferiores admisibles
+//--------------------------------
+/*
+  Todas las cotas son enteras y nunca superan el makespan de la mejor forma de
+  completar el estado, así que f = max(g, cota) es admisible. Se evalúan en
+  O(1) con los datos que el estado mantiene de forma incremental: 'restante',
+  cargas ordenadas (la máxima es carga[0], la mínima carga[M-1]) y, con las
+  tareas en orden LPT, las pendientes más largas son los primeros bits a 1.
+  - Heuristica2: la de 'calcularHeuristica2', ceil(carga total / M).
+  - L1: además, la tarea pendiente más larga irá como poco sobre la máquina
+    menos cargada: carga[M-1] + p_max.
+  - L2: además, entre las M+1 tareas pendientes más largas dos comparten
+    máquina: carga[M-1] + p_M + p_{M+1}; y la cota de la raíz 'cota_raiz'
+    (Dell'Amico–Martello), válida para cualquier estado porque ninguna
+    solución completa baja del óptimo.
+  - Automatica: se elige por instancia en 'elegirCotaInferior'.
+ */
+
+// Índice de la k-ésima tarea pendiente (k = 0 es la primera), o -1 si no hay tantas.
+inline int tareaPendienteK(const EstadoCompacto& estado, int k) {
+    for (int w = 0; w < PALABRAS_TAREAS; ++w) {
+        std::uint64_t bits = estado.pendientes[w];
+        int enPalabra = contarBits(bits);
+        if (k >= enPalabra) {
+            k -= enPalabra;
+            continue;
+        }
+        for (; k > 0; --k) bits &= bits - 1;
+        return w * 64 + bitMenor(bits);
+    }
+    return -1;
+}
+
+// Duración de la k-ésima tarea pendiente más larga, o 0 si no hay tantas.
+inline int tiempoPendienteK(const Instancia& inst, const EstadoCompacto& estado, int k) {
+    if (inst.tiempos_decrecientes) {
+        int tarea = tareaPendienteK(estado, k);
+        return tarea < 0 ? 0 : inst.tiempos[tarea];
+    }
+    // Sin orden LPT solo se usa k = 0: la máxima se busca recorriendo las pendientes.
+    if (k > 0) return 0;
+    int maximo = 0;
+    for (int w = 0; w < PALABRAS_TAREAS; ++w)
+        for (std::uint64_t bits = estado.pendientes[w]; bits; bits &= bits - 1)
+            maximo = std::max(maximo, inst.tiempos[w * 64 + bitMenor(bits)]);
+    return maximo;
+}
+
+template <int MF = 0>
+int calcularCotaInferior(const Instancia& inst, const EstadoCompacto& estado, CotaInferior tipo) {
+    const int M = numeroMaquinas<MF>(inst);
+    // ceil(carga total / M): la media de carga por máquina al terminar.
+    int cota = std::max(estado.carga[0], (inst.carga_total + M - 1) / M);
+    if (tipo == CotaInferior::Heuristica2 || estado.restante == 0) return cota;
+
+    int carga_min = estado.carga[M - 1];
+    cota = std::max(cota, carga_min + tiempoPendienteK(inst, estado, 0));
+    if (tipo == CotaInferior::L1) return cota;
+
+    int p_m1 = tiempoPendienteK(inst, estado, M);
+    if (p_m1 > 0) cota = std::max(cota, carga_min + tiempoPendienteK(inst, estado, M - 1) + p_m1);
+    return std::max(cota, inst.cota_raiz);
+}
+
+/*
+  Cota de Martello–Toth (L2 de bin packing): número mínimo de máquinas de
+  capacidad C necesarias para 'elementos' (ordenados de mayor a menor, todos
+  <= C). Para cada alfa <= C/2:
+    J1 = {p > C - alfa}, J2 = {C/2 < p <= C - alfa}, J3 = {alfa <= p <= C/2}
+    L(alfa) = |J1| + |J2| + max(0, ceil((Σ J3 - (|J2|·C - Σ J2)) / C))
+ */
+long long cotaBinPacking(const std::vector<int>& elementos, int C) {
+    long long mejor = 0;
+    std::vector<int> alfas = {0};
+    for (int p : elementos)
+        if (2LL * p <= C && (alfas.back() != p)) alfas.push_back(p);
+    for (int alfa : alfas) {
+        long long n12 = 0, suma2 = 0, n2 = 0, suma3 = 0;
+        for (int p : elementos) {
+            if (p > C - alfa) ++n12;
+            else if (2LL * p > C) { ++n12; ++n2; suma2 += p; }
+            else if (p >= alfa) suma3 += p;
+        }
+        long long hueco = n2 * C - suma2;
+        long long extra = suma3 > hueco ? (suma3 - hueco + C - 1) / C : 0;
+        mejor = std::max(mejor, n12 + extra);
+    }
+    return mejor;
+}
+
+/*
+  Cota del óptimo al estilo de Dell'Amico–Martello, calculada una vez por
+  instancia: parte de max(L1, p_M + p_{M+1}) y sube C mientras el bin packing
+  con capacidad C necesite más de M máquinas. Las cargas iniciales se tratan
+  como elementos más (relajación: se permite juntarlas), lo que mantiene la
+  cota válida. 'carga' son las M cargas iniciales.
+ */
+int cotaRaiz(const Instancia& inst, const int* carga) {
+    int M = inst.num_maquinas;
+    std::vector<int> elementos = inst.tiempos;
+    for (int j = 0; j < M; ++j)
+        if (carga[j] > 0) elementos.push_back(carga[j]);
+    if (elementos.empty()) return 0;
+    std::sort(elementos.begin(), elementos.end(), std::greater<int>());
+
+    int C = std::max(elementos[0], (inst.carga_total + M - 1) / M);
+    if (static_cast<int>(elementos.size()) > M) C = std::max(C, elementos[M - 1] + elementos[M]);
+    while (cotaBinPacking(elementos, C) > M) ++C;
+    return C;
+}
+
+/*
+  Elección por instancia: si en la raíz las cotas de L2 no mejoran a L1, se
+  usa L1, que es algo más barata; si no, L2. Con las tareas fuera del orden
+  LPT, L2 no puede localizar p_M y p_{M+1} en O(1) y se usa L1.
+ */
+CotaInferior elegirCotaInferior(const Instancia& inst, const EstadoCompacto& raiz) {
+    if (!inst.tiempos_decrecientes) return CotaInferior::L1;
+    int l1 = calcularCotaInferior(inst, raiz, CotaInferior::L1);
+    int l2 = calcularCotaInferior(inst, raiz, CotaInferior::L2);
+    return l2 > l1 ? CotaInferior::L2 : CotaInferior::L1;
+}
+
+//--------------------------------
+// Cota superior: LPT, MULTIFIT y búsqueda local
+//--------------------------------
+// Solución completa: maquina_de[i] = índice (en 'inst.id_maquina') de la
+// máquina de la tarea i. Las funciones de esta sección parten de las M
+// cargas iniciales 'carga_inicial', en el orden de 'inst.id_maquina'.
+struct Incumbente {
+    int makespan = std::numeric_limits<int>::max();
+    std::vector<int> maquina_de;
+};
+
+// Índices de las tareas de mayor a menor duración.
+std::vector<int> tareasPorDuracion(const Instancia& inst) {
+    std::vector<int> orden(inst.num_tareas);
+    std::iota(orden.begin(), orden.end(), 0);
+    if (!inst.tiempos_decrecientes) {
+        std::stable_sort(orden.begin(), orden.end(), [&](int a, int b) {
+            return inst.tiempos[a] > inst.tiempos[b];
+        });
+    }
+    return orden;
+}
+
+// LPT: cada tarea, de la más larga a la más corta, a la máquina menos cargada.
+Incumbente planificarLPT(const Instancia& inst, const int* carga_inicial) {
+    Incumbente sol;
+    sol.maquina_de.assign(inst.num_tareas, 0);
+    std::vector<int> carga(carga_inicial, carga_inicial + inst.num_maquinas);
+    for (int tarea : tareasPorDuracion(inst)) {
+        int j = static_cast<int>(std::min_element(carga.begin(), carga.end()) - carga.begin());
+        carga[j] += inst.tiempos[tarea];
+        sol.maquina_de[tarea] = j;
+    }
+    sol.makespan = *std::max_element(carga.begin(), carga.end());
+    return sol;
+}
+
+// First Fit Decreasing con capacidad C por máquina. Devuelve false si alguna tarea no cabe.
+bool empaquetarFFD(const Instancia& inst, const int* carga_inicial, const std::vector<int>& orden,
+                   int C, Incumbente& sol) {
+    std::vector<int> carga(carga_inicial, carga_inicial + inst.num_maquinas);
+    sol.maquina_de.assign(inst.num_tareas, 0);
+    for (int tarea : orden) {
+        int j = 0;
+        while (j < inst.num_maquinas && carga[j] + inst.tiempos[tarea] > C) ++j;
+        if (j == inst.num_maquinas) return false;
+        carga[j] += inst.tiempos[tarea];
+        sol.maquina_de[tarea] = j;
+    }
+    sol.makespan = *std::max_element(carga.begin(), carga.end());
+    return true;
+}
+
+// MULTIFIT: búsqueda binaria de la menor capacidad C en [cota_inf, mejor.makespan)
+// con la que FFD consigue colocar todas las tareas.
+void mejorarMULTIFIT(const Instancia& inst, const int* carga_inicial, int cota_inf, Incumbente& mejor) {
+    std::vector<int> orden = tareasPorDuracion(inst);
+    int lo = cota_inf, hi = mejor.makespan - 1;
+    Incumbente candidato;
+    while (lo <= hi) {
+        int C = lo + (hi - lo) / 2;
+        if (empaquetarFFD(inst, carga_inicial, orden, C, candidato)) {
+            if (candidato.makespan < mejor.makespan) mejor = candidato;
+            hi = C - 1;
+        } else {
+            lo = C + 1;
+        }
+    }
+}
+
+/*
+  Búsqueda local sobre la máquina más cargada: mueve una de sus tareas a otra
+  máquina, o la intercambia por una tarea más corta de otra máquina, siempre
+  que la mayor de las dos cargas resultantes quede por debajo de la actual.
+  Cada movimiento reduce estrictamente la suma de cuadrados de las cargas,
+  así que termina.
+ */
+void mejorarBusquedaLocal(const Instancia& inst, const int* carga_inicial, int cota_inf, Incumbente& sol) {
+    int M = inst.num_maquinas;
+    std::vector<int> carga(carga_inicial, carga_inicial + M);
+    for (int i = 0; i < inst.num_tareas; ++i) carga[sol.maquina_de[i]] += inst.tiempos[i];
 
-        // Mostrar IDs de tareas
-        std::cout << "  Tareas (IDs): ";
-        for (size_t i = 0; i < tareas_por_maquina[m.id].size(); ++i) {
-            std::cout << tareas_por_maquina[m.id][i];
-            if (i != tareas_por_maquina[m.id].size() - 1) std::cout << ", ";
+    bool mejora = true;
+    while (mejora) {
+        int a = static_cast<int>(std::max_element(carga.begin(), carga.end()) - carga.begin());
+        if (carga[a] <= cota_inf) break;
+        mejora = false;
+        for (int t = 0; t < inst.num_tareas && !mejora; ++t) {
+            if (sol.maquina_de[t] != a) continue;
+            int pt = inst.tiempos[t];
+            for (int b = 0; b < M && !mejora; ++b) {
+                if (b == a) continue;
+                if (carga[b] + pt < carga[a]) { // mover t de a a b
+                    carga[a] -= pt;
+                    carga[b] += pt;
+                    sol.maquina_de[t] = b;
+                    mejora = true;
+                    break;
+                }
+                for (int u = 0; u < inst.num_tareas; ++u) { // intercambiar t y u
+                    if (sol.maquina_de[u] != b || inst.tiempos[u] >= pt) continue;
+                    int delta = pt - inst.tiempos[u];
+                    if (carga[b] + delta < carga[a]) {
+                        carga[a] -= delta;
+                        carga[b] += delta;
+                        sol.maquina_de[t] = b;
+                        sol.maquina_de[u] = a;
+                        mejora = true;
+                        break;
+                    }
+                }
+            }
         }
+    }
+    sol.makespan = *std::max_element(carga.begin(), carga.end());
+}
+
+// Fase constructiva previa a la búsqueda: LPT, MULTIFIT y búsqueda local.
+Incumbente calcularCotaSuperior(const Instancia& inst, const int* carga_inicial, int cota_inf) {
+    Incumbente mejor = planificarLPT(inst, carga_inicial);
+    if (mejor.makespan > cota_inf) mejorarMULTIFIT(inst, carga_inicial, cota_inf, mejor);
+    if (mejor.makespan > cota_inf) mejorarBusquedaLocal(inst, carga_inicial, cota_inf, mejor);
+    return mejor;
+}
+
+/*
+  Incumbente a partir de una solución completa 'solucion' de la misma
+  instancia (mismos ids de tareas y máquinas). Devuelve false, sin tocar
+  'sol', si no asigna cada tarea exactamente una vez a una máquina conocida.
+ */
+bool incumbenteDesdeEstado(const Instancia& inst, const int* carga_inicial, const Estado& solucion,
+                           Incumbente& sol) {
+    std::map<int, int> indice_tarea, posicion_maquina;
+    for (int i = 0; i < inst.num_tareas; ++i) indice_tarea[inst.id_tarea[i]] = i;
+    for (int j = 0; j < inst.num_maquinas; ++j) posicion_maquina[inst.id_maquina[j]] = j;
+    if (static_cast<int>(solucion.Asignaciones.size()) != inst.num_tareas) return false;
+
+    std::vector<int> maquina_de(inst.num_tareas, -1);
+    std::vector<int> carga(carga_inicial, carga_inicial + inst.num_maquinas);
+    for (const Asignacion& a : solucion.Asignaciones) {
+        auto tarea = indice_tarea.find(a.tarea_id);
+        auto maquina = posicion_maquina.find(a.maquina_id);
+        if (tarea == indice_tarea.end() || maquina == posicion_maquina.end() || maquina_de[tarea->second] >= 0)
+            return false;
+        maquina_de[tarea->second] = maquina->second;
+        carga[maquina->second] += inst.tiempos[tarea->second];
+    }
+    sol.maquina_de = std::move(maquina_de);
+    sol.makespan = *std::max_element(carga.begin(), carga.end());
+    return true;
+}
+
+// Construye el 'Estado' final a partir de una solución completa.
+Estado estadoDesdeIncumbente(const Estado& estado_inicial, const Instancia& inst, const Incumbente& sol) {
+    MEDIR_FASE(Fase::Reconstruccion);
+    Estado solucion = estado_inicial;
+    for (int i = 0; i < inst.num_tareas; ++i)
+        solucion = asignarTarea(solucion, inst.id_tarea[i], inst.id_maquina[sol.maquina_de[i]]);
+    return solucion;
+}
+
+//--------------------------------
+// Generación de sucesores compacta
+//--------------------------------
+// Parámetros fijos de una búsqueda para 'generarSucesoresCompactos'.
+struct ReglasExpansion {
+    Ramificacion ramificacion = Ramificacion::OrdenFijo;
+    CotaInferior cota = CotaInferior::L1;
+    int f_limite = std::numeric_limits<int>::max(); // se descartan los sucesores con f >= f_limite
+};
+
+struct SucesorCompacto {
+    EstadoCompacto estado;
+    int g_cost;
+    int f_cost;
+    int tarea;   // índice de la tarea asignada
+    int maquina; // índice de la máquina que la recibe
+};
 
-        std::cout << "\n  Tiempos:      ";
-        for (size_t i = 0; i < tiempos_por_maquina[m.id].size(); ++i) {
-            std::cout << tiempos_por_maquina[m.id][i];
-            if (i != tiempos_por_maquina[m.id].size() - 1) std::cout << ", ";
+/*
+  Añade a 'sucesores' la asignación de 'tarea' a cada máquina distinta.
+  Poda por simetría: si una máquina tiene la misma carga que la anterior,
+  asignarle la tarea da el mismo estado canónico y no se genera.
+  Poda por cota: el f del hijo (con 'pathmax' desde f_padre) se calcula sobre la
+  pila y, si no mejora a la cota superior, el hijo no llega a guardarse.
+ */
+template <int MF>
+inline void ramificarEnMaquinas(const Instancia& inst, const EstadoCompacto& estado, int f_padre, int tarea,
+                                const ReglasExpansion& reglas, std::vector<SucesorCompacto>& sucesores) {
+    const int M = numeroMaquinas<MF>(inst);
+    for (int maquina = 0; maquina < M; ++maquina) {
+        if (maquina > 0 && estado.carga[maquina] == estado.carga[maquina - 1]) continue;
+        EstadoCompacto hijo = asignarTareaCompacta(inst, estado, tarea, maquina);
+        int f;
+        {
+            MEDIR_FASE(Fase::Evaluacion);
+            f = std::max(f_padre, calcularCotaInferior<MF>(inst, hijo, reglas.cota));
         }
+        if (f >= reglas.f_limite) continue;
+        sucesores.push_back({hijo, calcularCosteCompacto(inst, hijo), f, tarea, maquina});
+    }
+}
 
-        std::cout << "\n";
+/*
+  Equivalente compacto de 'generarSucesores'. Escribe los hijos en 'sucesores',
+  que se reutiliza entre expansiones: una vez alcanzada su capacidad máxima
+  no vuelve a reservar memoria.
+  - OrdenFijo: solo se asigna la primera tarea pendiente, así que el factor de
+    ramificación baja de |T|·|M| a |M| y cada asignación parcial se alcanza
+    por un único orden de tareas.
+  - TodasLasTareas: se prueban todas las tareas pendientes, pero las tareas de
+    igual duración son intercambiables: solo se asigna la primera pendiente de
+    cada duración. Así las pendientes de cada duración son siempre un sufijo y
+    dos estados con el mismo multiconjunto de duraciones tienen la misma clave.
+ */
+template <int MF = 0>
+void generarSucesoresCompactos(const Instancia& inst, const EstadoCompacto& estado, int f_padre,
+                               const ReglasExpansion& reglas, std::vector<SucesorCompacto>& sucesores) {
+    MEDIR_FASE(Fase::Sucesores);
+    sucesores.clear();
+    for (int w = 0; w < PALABRAS_TAREAS; ++w) {
+        for (std::uint64_t bits = estado.pendientes[w]; bits; bits &= bits - 1) {
+            int tarea = w * 64 + bitMenor(bits);
+            if (reglas.ramificacion == Ramificacion::OrdenFijo) {
+                ramificarEnMaquinas<MF>(inst, estado, f_padre, tarea, reglas, sucesores);
+                return;
+            }
+            int anterior = inst.anterior_igual[tarea];
+            if (anterior >= 0 && tareaPendiente(estado, anterior)) continue;
+            ramificarEnMaquinas<MF>(inst, estado, f_padre, tarea, reglas, sucesores);
+        }
+    }
+}
+
+//--------------------------------
+// Arena de nodos
+//--------------------------------
+/*
+  Reserva de nodos por bloques ("bump allocator"). Los nodos se direccionan por
+  índice y no se liberan de uno en uno: toda la memoria se devuelve de golpe
+  cuando la arena se destruye al terminar la búsqueda.
+ */
+template <typename T>
+struct ArenaNodos {
+    static constexpr int BITS_BLOQUE = 16;
+    static constexpr std::uint32_t NODOS_POR_BLOQUE = std::uint32_t{1} << BITS_BLOQUE;
+
+    std::vector<std::unique_ptr<T[]>> bloques;
+    std::uint32_t usados = 0;
+
+    std::uint32_t reservar(const T& nodo) {
+        if ((usados & (NODOS_POR_BLOQUE - 1)) == 0 && (usados >> BITS_BLOQUE) == bloques.size())
+            bloques.emplace_back(new T[NODOS_POR_BLOQUE]);
+        std::uint32_t indice = usados++;
+        (*this)[indice] = nodo;
+        return indice;
+    }
+    // Olvida los nodos pero conserva los bloques para la siguiente búsqueda.
+    void vaciar() { usados = 0; }
+    std::size_t bytes() const { return bloques.size() * NODOS_POR_BLOQUE * sizeof(T); }
+    T& operator[](std::uint32_t indice) {
+        return bloques[indice >> BITS_BLOQUE][indice & (NODOS_POR_BLOQUE - 1)];
+    }
+    const T& operator[](std::uint32_t indice) const {
+        return bloques[indice >> BITS_BLOQUE][indice & (NODOS_POR_BLOQUE - 1)];
+    }
+};
+
+constexpr std::uint32_t SIN_PADRE = 0xFFFFFFFFu;
+
+// Nodo de búsqueda guardado en la arena. En lugar del historial completo de
+// asignaciones solo guarda el padre y el movimiento (tarea, máquina) que lo creó.
+struct NodoArena {
+    EstadoCompacto estado;
+    int g_cost;
+    int f_cost;
+    std::uint32_t padre;
+    std::uint8_t tarea;
+    std::uint8_t maquina;
+    bool cerrado; // ya expandido
+};
+
+// Movimiento (tarea, posición de máquina en las cargas ordenadas) de un camino.
+struct Movimiento {
+    std::uint8_t tarea;
+    std::uint8_t maquina;
+};
+
+/*
+  Aplica con 'asignarTarea', en orden, los movimientos de un camino que parte
+  de un estado con cargas 'carga'. Los movimientos guardan posiciones
+  dentro de las cargas ordenadas, así que se repite la misma reordenación
+  manteniendo 'maquina_en[pos]', el índice en 'inst.id_maquina' de la máquina
+  que ocupa cada posición.
+ */
+Estado estadoDesdeMovimientos(const Estado& estado_inicial, const Instancia& inst,
+                              std::array<int, MAX_MAQUINAS> carga,
+                              const std::vector<Movimiento>& movimientos) {
+    MEDIR_FASE(Fase::Reconstruccion);
+    std::array<int, MAX_MAQUINAS> maquina_en;
+    std::iota(maquina_en.begin(), maquina_en.end(), 0);
+
+    Estado solucion = estado_inicial;
+    for (const Movimiento& mov : movimientos) {
+        solucion = asignarTarea(solucion, inst.id_tarea[mov.tarea], inst.id_maquina[maquina_en[mov.maquina]]);
+        int destino = sumarCargaCanonica(carga.data(), mov.maquina, inst.tiempos[mov.tarea]);
+        std::rotate(maquina_en.begin() + destino, maquina_en.begin() + mov.maquina,
+                    maquina_en.begin() + mov.maquina + 1);
+    }
+    return solucion;
+}
+
+/*
+  Reconstruye el 'Estado' completo de la solución: recorre los padres desde el
+  nodo meta hasta la raíz y aplica los movimientos encontrados. Solo se llama
+  una vez, al informar de la solución.
+ */
+Estado reconstruirEstado(const Estado& estado_inicial, const Instancia& inst,
+                         const ArenaNodos<NodoArena>& arena, std::uint32_t meta) {
+    std::vector<Movimiento> camino;
+    std::uint32_t raiz = meta;
+    {
+        MEDIR_FASE(Fase::Reconstruccion);
+        for (; arena[raiz].padre != SIN_PADRE; raiz = arena[raiz].padre)
+            camino.push_back({arena[raiz].tarea, arena[raiz].maquina});
+        std::reverse(camino.begin(), camino.end());
+    }
+    return estadoDesdeMovimientos(estado_inicial, inst, arena[raiz].estado.carga, camino);
+}
+
+//--------------------------------
+// Lista cerrada: tabla hash de estados vistos
+//--------------------------------
+/*
+  Tabla hash plana de direccionamiento abierto (sondeo lineal) indexada por
+  'EstadoCompacto::clave'. La clave es una suma, así que dos estados distintos
+  pueden compartirla: 'buscar' e 'insertar' reciben 'igual(valor)', que decide
+  si la entrada con esa clave es de verdad el mismo estado. Las variantes de A*
+  comparan el estado del nodo 'arena[valor]'; una entrada con la clave pero
+  otro estado se pasa de largo, y los dos estados conviven en la tabla.
+  Sin predicado ('SoloClave') basta la clave: así se inserta la raíz en una
+  tabla vacía. IDA* no tiene nodos con los que comparar y usa 'TablaCotas'.
+  - presupuesto_bytes == 0: la tabla crece (duplicando) al llenarse a la mitad.
+  - presupuesto_bytes > 0: tamaño fijo. Si los SONDEO_MAXIMO huecos de una
+    clave están ocupados, se reemplaza la entrada más profunda, la más barata
+    de volver a generar. Perder una entrada solo provoca una re-expansión.
+ */
+struct TablaTransposicion {
+    struct Entrada {
+        std::uint64_t clave = 0; // 0 = hueco libre
+        int valor = 0;           // en A*, el índice del nodo en la arena
+        int profundidad = 0;     // tareas ya asignadas en el estado
+    };
+    static constexpr int SONDEO_MAXIMO = 8;
+
+    std::vector<Entrada> entradas;
+    std::size_t mascara = 0;
+    std::size_t ocupadas = 0;
+    bool tamano_fijo = false;
+
+    explicit TablaTransposicion(std::size_t presupuesto_bytes = 0) { vaciar(presupuesto_bytes); }
+
+    // Deja la tabla vacía con el presupuesto dado. Si crece, conserva la
+    // capacidad alcanzada en búsquedas anteriores en lugar de reservar otra vez.
+    void vaciar(std::size_t presupuesto_bytes) {
+        std::size_t capacidad = std::size_t{1} << 12;
+        tamano_fijo = presupuesto_bytes > 0;
+        if (tamano_fijo) {
+            while (capacidad * 2 * sizeof(Entrada) <= presupuesto_bytes) capacidad *= 2;
+        } else {
+            capacidad = std::max(capacidad, entradas.size());
+        }
+        entradas.assign(capacidad, Entrada{});
+        mascara = capacidad - 1;
+        ocupadas = 0;
+    }
+
+    struct SoloClave {
+        bool operator()(int) const { return true; }
+    };
+
+    static std::uint64_t normalizar(std::uint64_t clave) { return clave ? clave : 1; }
+    std::size_t bytes() const { return entradas.capacity() * sizeof(Entrada); }
+
+    template <class Igual = SoloClave>
+    Entrada* buscar(std::uint64_t clave, Igual igual = {}) {
+        clave = normalizar(clave);
+        std::size_t i = clave & mascara;
+        for (int s = 0; s < (tamano_fijo ? SONDEO_MAXIMO : static_cast<int>(entradas.size())); ++s) {
+            Entrada& e = entradas[(i + s) & mascara];
+            if (e.clave == clave && igual(e.valor)) return &e;
+            if (e.clave == 0) return nullptr;
+        }
+        return nullptr;
+    }
+
+    // Sobrescribe la entrada del mismo estado si la hay; si no, ocupa un hueco.
+    template <class Igual = SoloClave>
+    void insertar(std::uint64_t clave, int valor, int profundidad, Igual igual = {}) {
+        if (!tamano_fijo && 2 * (ocupadas + 1) > entradas.size()) crecer();
+        clave = normalizar(clave);
+        std::size_t i = clave & mascara;
+        Entrada* victima = nullptr;
+        for (std::size_t s = 0;; ++s) {
+            Entrada& e = entradas[(i + s) & mascara];
+            if ((e.clave == clave && igual(e.valor)) || e.clave == 0) {
+                if (e.clave == 0) ++ocupadas;
+                e = {clave, valor, profundidad};
+                return;
+            }
+            if (tamano_fijo) {
+                if (!victima || e.profundidad > victima->profundidad) victima = &e;
+                if (s + 1 == SONDEO_MAXIMO) break;
+            }
+        }
+        *victima = {clave, valor, profundidad}; // reemplazo: la tabla está llena en esta zona
+    }
+
+    void crecer() {
+        std::vector<Entrada> antiguas(entradas.size() * 2);
+        antiguas.swap(entradas);
+        mascara = entradas.size() - 1;
+        for (const Entrada& e : antiguas) {
+            if (e.clave == 0) continue;
+            std::size_t i = e.clave & mascara;
+            while (entradas[i].clave != 0) i = (i + 1) & mascara;
+            entradas[i] = e;
+        }
+    }
+};
+
+//--------------------------------
+// Lista abierta: cola de cubetas
+//--------------------------------
+/*
+  Los f_cost son enteros pequeños (acotados por la suma de los tiempos), así
+  que la lista abierta es un vector de cubetas, una por valor de f, con los
+  índices de los nodos en la arena. Insertar y extraer son O(1) amortizado.
+  Dentro de una cubeta se extrae en orden LIFO: entre nodos con igual f sale
+  primero el último generado, que es el más profundo (mayor g).
+  Una entrada puede quedar obsoleta si el nodo se mejora y se reinserta con
+  otro f; quien extrae debe descartarla comparando con el f_cost del nodo.
+ */
+struct ColaCubetas {
+    std::vector<std::vector<std::uint32_t>> cubetas;
+    int minimo = 0;          // ninguna cubeta por debajo de 'minimo' tiene nodos
+    std::size_t tamano = 0;
+
+    explicit ColaCubetas(int f_maximo = 0) : cubetas(static_cast<std::size_t>(f_maximo) + 1) {}
+
+    // Vacía la cola conservando la memoria de las cubetas.
+    void vaciar(int f_maximo) {
+        for (auto& cubeta : cubetas) cubeta.clear();
+        if (cubetas.size() < static_cast<std::size_t>(f_maximo) + 1) cubetas.resize(static_cast<std::size_t>(f_maximo) + 1);
+        minimo = 0;
+        tamano = 0;
+    }
+
+    bool vacia() const { return tamano == 0; }
+
+    std::size_t bytes() const {
+        std::size_t total = cubetas.capacity() * sizeof(cubetas[0]);
+        for (const auto& cubeta : cubetas) total += cubeta.capacity() * sizeof(std::uint32_t);
+        return total;
+    }
+
+    void insertar(int f, std::uint32_t nodo) {
+        if (static_cast<std::size_t>(f) >= cubetas.size()) cubetas.resize(static_cast<std::size_t>(f) + 1);
+        cubetas[f].push_back(nodo);
+        minimo = std::min(minimo, f);
+        ++tamano;
+    }
+
+    // Extrae un nodo de la cubeta no vacía de menor f (la cola no debe estar vacía).
+    std::uint32_t extraer(int& f) {
+        while (cubetas[minimo].empty()) ++minimo;
+        f = minimo;
+        std::uint32_t nodo = cubetas[minimo].back();
+        cubetas[minimo].pop_back();
+        --tamano;
+        return nodo;
+    }
+};
+
+//--------------------------------
+// Preparación común de la búsqueda
+//--------------------------------
+// Lo que comparten los motores exactos antes de empezar a expandir.
+struct PreparacionBusqueda {
+    Instancia inst;
+    EstadoCompacto raiz;
+    ReglasExpansion reglas;
+    int f_inicial = 0;
+    Incumbente incumbente; // vacío (makespan máximo) si no se calcula cota superior
+};
+
+/*
+  Compacta el estado inicial, elige la cota inferior y calcula la cota
+  superior: la mejor entre la constructiva y 'opciones.solucion_previa'.
+  Devuelve false si el estado no cabe en la codificación compacta.
+ */
+bool prepararBusqueda(const Estado& estado_inicial, const OpcionesBusqueda& opciones,
+                      PreparacionBusqueda& prep) {
+    MEDIR_FASE(Fase::Preparacion);
+    if (!compactarEstado(estado_inicial, opciones.orden, prep.inst, prep.raiz)) return false;
+
+    prep.reglas = ReglasExpansion{};
+    prep.incumbente = Incumbente{};
+    prep.reglas.ramificacion = opciones.ramificacion;
+    prep.reglas.cota = opciones.cota;
+    if (prep.reglas.cota == CotaInferior::L2 || prep.reglas.cota == CotaInferior::Automatica)
+        prep.inst.cota_raiz = cotaRaiz(prep.inst, prep.raiz.carga.data());
+    if (prep.reglas.cota == CotaInferior::Automatica)
+        prep.reglas.cota = elegirCotaInferior(prep.inst, prep.raiz);
+
+    prep.f_inicial = std::max(calcularCotaInferior(prep.inst, prep.raiz, prep.reglas.cota),
+                              opciones.cota_inferior_previa);
+    if (opciones.cota_superior) {
+        if (opciones.solucion_previa)
+            incumbenteDesdeEstado(prep.inst, prep.raiz.carga.data(), *opciones.solucion_previa, prep.incumbente);
+        // La fase constructiva sobra si la solución previa ya alcanza la cota.
+        if (prep.incumbente.makespan > prep.f_inicial) {
+            Incumbente constructiva = calcularCotaSuperior(prep.inst, prep.raiz.carga.data(), prep.f_inicial);
+            if (constructiva.makespan < prep.incumbente.makespan) prep.incumbente = std::move(constructiva);
+        }
+        prep.reglas.f_limite = prep.incumbente.makespan;
+        anunciarCotaSuperior(opciones, prep.incumbente.makespan);
+    }
+    anunciarCotaInferior(opciones, std::max(prep.f_inicial, prep.inst.cota_raiz));
+    return true;
+}
+
+/*
+  Preparación sin codificación compacta, para los motores en profundidad
+  (IDA* y la ramificación y poda) cuando la instancia pasa de MAX_MAQUINAS
+  máquinas o de MAX_TAREAS tareas. Rellena la misma 'Instancia', con las
+  tareas siempre en orden LPT y las máquinas en orden canónico, y deja las
+  cargas iniciales en un vector. 'f_inicial' es la cota L2 de la raíz y la
+  cota superior es la de 'prepararBusqueda'. Devuelve false si no hay
+  máquinas o si no son idénticas.
+ */
+struct PreparacionAmplia {
+    Instancia inst;
+    std::vector<int> carga; // cargas iniciales, de mayor a menor
+    int f_inicial = 0;
+    Incumbente incumbente;  // vacío (makespan máximo) si no se calcula cota superior
+};
+
+bool prepararAmplia(const Estado& estado_inicial, const OpcionesBusqueda& opciones, PreparacionAmplia& prep) {
+    MEDIR_FASE(Fase::Preparacion);
+    if (estado_inicial.M.empty() || modeloMaquinas(estado_inicial) != ModeloMaquinas::Identicas) return false;
+    Instancia& inst = prep.inst;
+    inst = Instancia{};
+    inst.num_maquinas = static_cast<int>(estado_inicial.M.size());
+    inst.num_tareas = static_cast<int>(estado_inicial.T.size());
+    std::vector<Maquina> maquinas = estado_inicial.M;
+    std::stable_sort(maquinas.begin(), maquinas.end(), [](const Maquina& a, const Maquina& b) {
+        return a.tiempo_ocupado > b.tiempo_ocupado;
+    });
+    prep.carga.clear();
+    for (const Maquina& m : maquinas) {
+        inst.id_maquina.push_back(m.id);
+        prep.carga.push_back(m.tiempo_ocupado);
+        inst.carga_total += m.tiempo_ocupado;
+    }
+    std::vector<Tarea> tareas = estado_inicial.T;
+    std::stable_sort(tareas.begin(), tareas.end(), [](const Tarea& a, const Tarea& b) { return a.tiempo > b.tiempo; });
+    for (const Tarea& t : tareas) {
+        inst.id_tarea.push_back(t.id);
+        inst.tiempos.push_back(t.tiempo);
+        inst.carga_total += t.tiempo;
+    }
+    inst.tiempos_decrecientes = true;
+    inst.cota_raiz = cotaRaiz(inst, prep.carga.data());
+
+    const int M = inst.num_maquinas;
+    prep.f_inicial = std::max({prep.carga[0], (inst.carga_total + M - 1) / M, inst.cota_raiz,
+                               opciones.cota_inferior_previa});
+    prep.incumbente = Incumbente{};
+    if (opciones.cota_superior) {
+        if (opciones.solucion_previa)
+            incumbenteDesdeEstado(inst, prep.carga.data(), *opciones.solucion_previa, prep.incumbente);
+        if (prep.incumbente.makespan > prep.f_inicial) {
+            Incumbente constructiva = calcularCotaSuperior(inst, prep.carga.data(), prep.f_inicial);
+            if (constructiva.makespan < prep.incumbente.makespan) prep.incumbente = std::move(constructiva);
+        }
+        anunciarCotaSuperior(opciones, prep.incumbente.makespan);
+    }
+    anunciarCotaInferior(opciones, prep.f_inicial);
+    return true;
+}
+
+/*
+  Equivalente de la preparación para máquinas uniformes o no relacionadas,
+  que no admiten la forma canónica: las máquinas quedan en el orden de
+  'Estado::M' (posición j = 'inst.id_maquina[j]') y los tiempos de cada
+  tarea en cada máquina van a 'tiempos', fila por índice de tarea. Como
+  duración de la tarea, 'inst.tiempos' guarda la mínima en cualquier
+  máquina: con ella se ordenan las tareas y se calculan las cotas.
+  Con máquinas idénticas 'tiempos' queda vacía (ver 'duracionModelo').
+ */
+struct InstanciaModelo {
+    ModeloMaquinas modelo = ModeloMaquinas::Identicas;
+    Instancia inst;
+    MatrizTiempos tiempos;
+    std::vector<int> carga;     // carga inicial por posición de máquina
+    std::vector<int> velocidad; // por posición de máquina
+    long long total = 0;        // Σ cargas iniciales + Σ duraciones mínimas
+};
+
+void prepararModelo(const Estado& estado, InstanciaModelo& im) {
+    const int M = static_cast<int>(estado.M.size());
+    const int n = static_cast<int>(estado.T.size());
+    im.modelo = modeloMaquinas(estado);
+    im.inst = Instancia{};
+    im.inst.num_maquinas = M;
+    im.inst.num_tareas = n;
+    im.tiempos = MatrizTiempos();
+    im.carga.assign(M, 0);
+    im.velocidad.assign(M, 100);
+    im.total = 0;
+    for (int j = 0; j < M; ++j) {
+        im.inst.id_maquina.push_back(estado.M[j].id);
+        im.carga[j] = estado.M[j].tiempo_ocupado;
+        im.velocidad[j] = estado.M[j].velocidad;
+        im.total += im.carga[j];
+    }
+    const bool identicas = im.modelo == ModeloMaquinas::Identicas;
+    if (!identicas) im.tiempos = MatrizTiempos(n, M);
+    for (int i = 0; i < n; ++i) {
+        im.inst.id_tarea.push_back(estado.T[i].id);
+        if (identicas) {
+            im.inst.tiempos.push_back(estado.T[i].tiempo);
+        } else {
+            int* fila = im.tiempos.fila(i);
+            for (int j = 0; j < M; ++j) fila[j] = duracionEn(estado, estado.T[i], j);
+            im.inst.tiempos.push_back(M ? *std::min_element(fila, fila + M) : estado.T[i].tiempo);
+        }
+        im.total += im.inst.tiempos.back();
+    }
+}
+
+// Lo que tarda la tarea de índice t en la máquina de posición j.
+inline int duracionModelo(const InstanciaModelo& im, int t, int j) {
+    return im.modelo == ModeloMaquinas::Identicas ? im.inst.tiempos[t] : im.tiempos(t, j);
+}
+
+/*
+  Cota inferior del óptimo: la carga media contando cada tarea por su
+  duración mínima, lo que tarda en terminar cada tarea en la máquina donde
+  antes acabaría y la mayor carga inicial. Con máquinas idénticas, también
+  p_M + p_{M+1}: dos de las M + 1 tareas más largas comparten máquina.
+ */
+int cotaInferiorModelo(const InstanciaModelo& im) {
+    const int M = im.inst.num_maquinas;
+    if (M == 0) return 0;
+    int cota = static_cast<int>((im.total + M - 1) / M);
+    cota = std::max(cota, *std::max_element(im.carga.begin(), im.carga.end()));
+    for (int i = 0; i < im.inst.num_tareas; ++i) {
+        int fin = std::numeric_limits<int>::max();
+        for (int j = 0; j < M; ++j) fin = std::min(fin, im.carga[j] + duracionModelo(im, i, j));
+        cota = std::max(cota, fin);
+    }
+    if (im.modelo == ModeloMaquinas::Identicas && im.inst.num_tareas > M) {
+        std::vector<int> tiempos = im.inst.tiempos;
+        std::nth_element(tiempos.begin(), tiempos.begin() + M, tiempos.end(), std::greater<int>());
+        cota = std::max(cota, *std::min_element(tiempos.begin(), tiempos.begin() + M) + tiempos[M]);
+    }
+    return cota;
+}
+
+// ECT: cada tarea, de mayor a menor duración mínima, a la máquina donde antes
+// termina. Con máquinas idénticas es LPT.
+Incumbente planificarECT(const InstanciaModelo& im) {
+    const int M = im.inst.num_maquinas;
+    std::vector<int> carga = im.carga;
+    Incumbente sol;
+    sol.maquina_de.assign(im.inst.num_tareas, 0);
+    for (int t : tareasPorDuracion(im.inst)) {
+        int mejor = 0, fin_mejor = M ? carga[0] + duracionModelo(im, t, 0) : 0;
+        for (int j = 1; j < M; ++j) {
+            int fin = carga[j] + duracionModelo(im, t, j);
+            if (fin < fin_mejor) {
+                mejor = j;
+                fin_mejor = fin;
+            }
+        }
+        carga[mejor] = fin_mejor;
+        sol.maquina_de[t] = mejor;
+    }
+    sol.makespan = M ? *std::max_element(carga.begin(), carga.end()) : 0;
+    return sol;
+}
+
+/*
+  Memoria de trabajo de 'A_estrella'. Quien resuelve muchas instancias
+  seguidas (ver 'resolverLote') la reutiliza: la arena, la tabla y las
+  cubetas se vacían sin liberar, así que tras las primeras instancias la
+  búsqueda deja de reservar memoria.
+ */
+struct MemoriaBusqueda {
+    PreparacionBusqueda prep;
+    ArenaNodos<NodoArena> arena;
+    TablaTransposicion vistos;
+    ColaCubetas abierta;
+    std::vector<SucesorCompacto> sucesores;
+    std::vector<std::uint32_t> tabla_pd; // tabla de 'DecisionBinPacking'
+
+    std::size_t bytes() const {
+        return arena.bytes() + vistos.bytes() + abierta.bytes() + sucesores.capacity() * sizeof(SucesorCompacto) +
+               tabla_pd.capacity() * sizeof(std::uint32_t);
+    }
+};
+
+//--------------------------------
+// Algoritmo de Búsqueda: A* en memoria externa
+//--------------------------------
+/*
+  Modo de 'A_estrella' para búsquedas que no caben en RAM; se activa con
+  'opciones.directorio_externo'. Al estilo del A* externo con detección
+  diferida de duplicados, la lista abierta se reparte en cubetas (f, d), con
+  d el número de tareas asignadas (se ramifica siempre en OrdenFijo, así que
+  las pendientes a profundidad d son las tareas d..n-1), y cada cubeta es un
+  fichero de registros de ancho fijo: las M cargas ordenadas, 4·M bytes.
+  Las cubetas se procesan por f creciente y, dentro de cada f, por d
+  creciente. Procesar (f, d) es:
+  1. Ordenar la cubeta sin repetidos: tramos ordenados en RAM y, si hay
+     más de uno, mezcla de k vías.
+  2. En una sola pasada de mezcla con el fichero ordenado de cerrados de
+     profundidad d, quitarle los ya cerrados y unirla a ellos.
+  3. Expandir lo que queda. Cada hijo va a la cubeta (f', d+1), f' >= f, a
+     través de un búfer en RAM que se escribe en bloques de BLOQUE_EXTERNO;
+     si los búferes de todas las f' pasan de 'PresupuestoExterno::hijos',
+     se vuelca antes el mayor.
+  La primera cubeta (f, n) no vacía contiene metas de makespan f: óptimas;
+  en la práctica la búsqueda para antes, al generar la primera meta con f
+  igual al de la capa que se expande.
+  Todo el acceso a disco es secuencial menos la reconstrucción del camino,
+  que busca hacia atrás, en los cerrados de cada profundidad, un predecesor
+  de cada estado (restando la duración de la tarea a una de sus cargas).
+  Toda la RAM de la búsqueda sale de 'memoria_externa' (ver
+  'PresupuestoExterno'): los tramos, y los búferes de cada fichero abierto.
+  La mezcla abre como mucho MAX_VIAS_MEZCLA tramos a la vez y, si hay más,
+  los mezcla en varias pasadas.
+  Si falla la lectura o la escritura de algún fichero (disco lleno, límite
+  de ficheros abiertos) la búsqueda se abandona, el motivo queda en
+  'opciones.error' y se devuelve la solución constructiva, como cuando no se
+  encuentra solución; nunca se toma un fichero ilegible por uno vacío.
+ */
+constexpr std::size_t BLOQUE_EXTERNO = std::size_t{1} << 20; // bytes por lectura o escritura, como mucho
+constexpr int MAX_VIAS_MEZCLA = 16; // tramos abiertos a la vez en cada pasada de mezcla
+
+// Un registro suelto (cabeza de un tramo, estado en expansión); en disco solo
+// van las M primeras cargas. Los tramos en RAM van en un vector plano de M
+// enteros por registro.
+using RegistroExterno = std::array<int, MAX_MAQUINAS>;
+
+/*
+  Reparto de 'memoria_externa' entre los búferes de E/S y los tramos que se
+  ordenan en RAM: la mezcla abre 'vias' lectores y un escritor de 'bufer'
+  bytes, y la ordenación un lector, un escritor y 'capacidad' registros de
+  4·M bytes más su índice de 4 bytes. Al expandir una cubeta solo hay un
+  lector abierto; el resto, 'hijos' bytes, es para los búferes de los hijos
+  de todas las cubetas de destino juntos.
+ */
+struct PresupuestoExterno {
+    std::size_t bufer;
+    std::size_t capacidad;
+    int vias;
+    std::size_t bytes; // total cubierto por el reparto
+    std::size_t hijos; // búferes de los hijos en 'BusquedaExterna::expandir', sumados
+
+    PresupuestoExterno(std::size_t memoria, int M) {
+        const std::size_t registro = sizeof(int) * M;
+        bufer = std::max(registro, std::min(BLOQUE_EXTERNO, memoria / (MAX_VIAS_MEZCLA + 1)) / registro * registro);
+        vias = static_cast<int>(std::clamp<std::size_t>(memoria / bufer, 3, MAX_VIAS_MEZCLA + 1) - 1);
+        const std::size_t resto = memoria > 2 * bufer ? memoria - 2 * bufer : 0;
+        capacidad = std::max<std::size_t>(1, resto / (registro + sizeof(std::uint32_t)));
+        bytes = std::max(static_cast<std::size_t>(vias + 1) * bufer,
+                         2 * bufer + capacidad * (registro + sizeof(std::uint32_t)));
+        hijos = bytes - bufer;
+    }
+};
+
+/*
+  Lectura secuencial, por bloques, de un fichero de registros de M cargas.
+  No poder abrir o leer el fichero es un error ('error'), nunca un fichero
+  vacío: quien sabe que un fichero aún no existe no crea el lector.
+ */
+struct LectorRegistros {
+    std::FILE* f;
+    int M;
+    std::vector<int> bufer;
+    std::size_t pos = 0, fin = 0;
+    bool error;
+
+    LectorRegistros(const std::string& ruta, int M_, std::size_t bytes_bufer)
+        : f(std::fopen(ruta.c_str(), "rb")), M(M_),
+          bufer(std::max<std::size_t>(1, bytes_bufer / sizeof(int) / M_) * M_), error(f == nullptr) {}
+    ~LectorRegistros() {
+        if (f) std::fclose(f);
+    }
+
+    bool siguiente(RegistroExterno& r) {
+        if (pos == fin) {
+            if (!f) return false;
+            fin = std::fread(bufer.data(), sizeof(int) * M, bufer.size() / M, f) * M;
+            pos = 0;
+            if (fin == 0) {
+                if (std::ferror(f)) error = true;
+                return false;
+            }
+        }
+        std::copy_n(&bufer[pos], M, r.begin());
+        pos += M;
+        return true;
+    }
+};
+
+// Escritura secuencial, por bloques; 'modo' "ab" añade al final.
+struct EscritorRegistros {
+    std::FILE* f;
+    int M;
+    std::size_t bytes_bufer;
+    std::vector<int> bufer;
+    long long escritos = 0;
+    bool error;
+
+    EscritorRegistros(const std::string& ruta, int M_, std::size_t bytes_bufer_, const char* modo = "wb")
+        : f(std::fopen(ruta.c_str(), modo)), M(M_), bytes_bufer(bytes_bufer_), error(f == nullptr) {
+        bufer.reserve(bytes_bufer / sizeof(int) + M);
+    }
+    ~EscritorRegistros() { cerrar(); }
+
+    void escribir(const int* r) {
+        bufer.insert(bufer.end(), r, r + M);
+        ++escritos;
+        if (bufer.size() * sizeof(int) >= bytes_bufer) vaciar();
+    }
+    void escribir(const RegistroExterno& r) { escribir(r.data()); }
+    void vaciar() {
+        if (f && !bufer.empty() && std::fwrite(bufer.data(), sizeof(int), bufer.size(), f) != bufer.size())
+            error = true;
+        bufer.clear();
+    }
+    bool cerrar() {
+        if (f) {
+            vaciar();
+            if (std::fclose(f) != 0) error = true;
+            f = nullptr;
+        }
+        return !error;
+    }
+};
+
+// Mezcla de k vías de 'tramos' (ordenados, sin repetidos) en 'salida', sin repetidos.
+bool mezclarTramos(const std::vector<std::string>& tramos, const std::string& salida, int M, std::size_t bufer,
+                   long long& repetidos) {
+    std::vector<std::unique_ptr<LectorRegistros>> lectores;
+    std::vector<RegistroExterno> cabeza(tramos.size());
+    auto mayor = [&](std::size_t a, std::size_t b) { return cabeza[b] < cabeza[a]; };
+    std::priority_queue<std::size_t, std::vector<std::size_t>, decltype(mayor)> cola(mayor);
+    for (std::size_t i = 0; i < tramos.size(); ++i) {
+        lectores.push_back(std::make_unique<LectorRegistros>(tramos[i], M, bufer));
+        if (lectores[i]->error) return false;
+        if (lectores[i]->siguiente(cabeza[i])) cola.push(i);
+    }
+    EscritorRegistros escritor(salida, M, bufer);
+    RegistroExterno ultimo{};
+    bool hay_ultimo = false;
+    while (!cola.empty()) {
+        std::size_t i = cola.top();
+        cola.pop();
+        if (hay_ultimo && cabeza[i] == ultimo) {
+            ++repetidos;
+        } else {
+            escritor.escribir(cabeza[i]);
+            ultimo = cabeza[i];
+            hay_ultimo = true;
+        }
+        if (lectores[i]->siguiente(cabeza[i])) cola.push(i);
+    }
+    bool ok = std::none_of(lectores.begin(), lectores.end(), [](const auto& l) { return l->error; });
+    return escritor.cerrar() && ok;
+}
+
+/*
+  Ordena 'entrada' sin repetidos y deja el resultado en 'salida'. Si hay más
+  de 'presupuesto.capacidad' registros, escribe tramos ordenados y los mezcla
+  por pasadas de 'presupuesto.vias' tramos como mucho, hasta que queda uno.
+  Suma a 'repetidos' los eliminados.
+ */
+bool ordenarSinRepetidos(const std::string& entrada, const std::string& salida, int M,
+                         const PresupuestoExterno& presupuesto, long long& repetidos) {
+    std::vector<std::string> tramos;
+    auto borrarTramos = [&] {
+        for (const std::string& t : tramos) std::remove(t.c_str());
+    };
+    int siguiente_tramo = 0;
+    auto nuevoTramo = [&] { return salida + ".t" + std::to_string(siguiente_tramo++); };
+    {
+        LectorRegistros lector(entrada, M, presupuesto.bufer);
+        std::vector<int> cargas;             // M enteros por registro
+        std::vector<std::uint32_t> indices;  // orden de los registros de 'cargas'
+        auto menor = [&](std::uint32_t a, std::uint32_t b) {
+            return std::lexicographical_compare(&cargas[a * M], &cargas[a * M] + M, &cargas[b * M], &cargas[b * M] + M);
+        };
+        auto igual = [&](std::uint32_t a, std::uint32_t b) {
+            return std::equal(&cargas[a * M], &cargas[a * M] + M, &cargas[b * M]);
+        };
+        RegistroExterno r{};
+        bool hay = lector.siguiente(r);
+        bool fallo = false;
+        do {
+            cargas.clear();
+            for (; hay && cargas.size() / M < presupuesto.capacidad; hay = lector.siguiente(r))
+                cargas.insert(cargas.end(), r.begin(), r.begin() + M);
+            if ((fallo = lector.error)) break;
+            indices.resize(cargas.size() / M);
+            std::iota(indices.begin(), indices.end(), 0u);
+            std::sort(indices.begin(), indices.end(), menor);
+            std::size_t unicos = static_cast<std::size_t>(std::unique(indices.begin(), indices.end(), igual) -
+                                                          indices.begin());
+            repetidos += static_cast<long long>(indices.size() - unicos);
+            std::string ruta = (!hay && tramos.empty()) ? salida : nuevoTramo();
+            EscritorRegistros escritor(ruta, M, presupuesto.bufer);
+            for (std::size_t i = 0; i < unicos; ++i) escritor.escribir(&cargas[indices[i] * M]);
+            if (ruta != salida) tramos.push_back(ruta);
+            if ((fallo = !escritor.cerrar())) break;
+            if (ruta == salida) return true; // un solo tramo: ya está
+        } while (hay);
+        if (fallo) {
+            borrarTramos();
+            return false;
+        }
+    }
+
+    // Pasadas de mezcla: cada grupo de 'vias' tramos pasa a ser uno.
+    while (tramos.size() > static_cast<std::size_t>(presupuesto.vias)) {
+        std::vector<std::string> siguientes;
+        for (std::size_t i = 0; i < tramos.size(); i += presupuesto.vias) {
+            std::vector<std::string> grupo(tramos.begin() + i,
+                                           tramos.begin() + std::min(tramos.size(), i + presupuesto.vias));
+            std::string ruta = nuevoTramo();
+            siguientes.push_back(ruta);
+            bool ok = mezclarTramos(grupo, ruta, M, presupuesto.bufer, repetidos);
+            for (const std::string& t : grupo) std::remove(t.c_str());
+            if (!ok) {
+                for (std::size_t k = i + presupuesto.vias; k < tramos.size(); ++k) std::remove(tramos[k].c_str());
+                tramos = std::move(siguientes);
+                borrarTramos();
+                return false;
+            }
+        }
+        tramos = std::move(siguientes);
+    }
+    bool ok = mezclarTramos(tramos, salida, M, presupuesto.bufer, repetidos);
+    borrarTramos();
+    return ok;
+}
+
+/*
+  Una pasada de mezcla sobre dos ficheros ordenados sin repetidos: 'nuevos'
+  recibe los registros de 'cubeta' que no están en 'cerrados', y 'union_'
+  la unión de ambos. Suma a 'repetidos' los registros ya cerrados. Con
+  'hay_cerrados' a false todavía no hay cerrados a esa profundidad y no se
+  abre ningún fichero para ellos.
+ */
+bool restarYUnir(const std::string& cubeta, const std::string& cerrados, bool hay_cerrados, const std::string& nuevos,
+                 const std::string& union_, int M, std::size_t bufer, long long& repetidos) {
+    LectorRegistros a(cubeta, M, bufer);
+    std::unique_ptr<LectorRegistros> b;
+    if (hay_cerrados) b = std::make_unique<LectorRegistros>(cerrados, M, bufer);
+    if (a.error || (b && b->error)) return false;
+    EscritorRegistros sal_nuevos(nuevos, M, bufer), sal_union(union_, M, bufer);
+    RegistroExterno x{}, y{};
+    bool hay_x = a.siguiente(x), hay_y = b && b->siguiente(y);
+    while (hay_x || hay_y) {
+        if (hay_x && hay_y && x == y) {
+            ++repetidos;
+            sal_union.escribir(y);
+            hay_x = a.siguiente(x);
+            hay_y = b->siguiente(y);
+        } else if (hay_x && (!hay_y || x < y)) {
+            sal_nuevos.escribir(x);
+            sal_union.escribir(x);
+            hay_x = a.siguiente(x);
+        } else {
+            sal_union.escribir(y);
+            hay_y = b->siguiente(y);
+        }
+    }
+    bool ok_nuevos = sal_nuevos.cerrar();
+    bool ok_union = sal_union.cerrar();
+    return ok_nuevos && ok_union && !a.error && !(b && b->error);
+}
+
+// Busca 'r' en un fichero ordenado de registros. Solo para reconstruir el
+// camino. Si no puede abrir o leer el fichero, pone 'error' a true.
+bool contieneRegistro(const std::string& ruta, int M, const RegistroExterno& r, bool& error) {
+    std::FILE* f = std::fopen(ruta.c_str(), "rb");
+    if (!f) {
+        error = true;
+        return false;
+    }
+    const long tam = static_cast<long>(sizeof(int)) * M;
+    std::fseek(f, 0, SEEK_END);
+    long bajo = 0, alto = std::ftell(f) / tam;
+    RegistroExterno medio{};
+    bool encontrado = false;
+    while (bajo < alto && !encontrado) {
+        long m = bajo + (alto - bajo) / 2;
+        std::fseek(f, m * tam, SEEK_SET);
+        if (std::fread(medio.data(), tam, 1, f) != 1) {
+            error = true;
+            break;
+        }
+        if (std::lexicographical_compare(medio.begin(), medio.begin() + M, r.begin(), r.begin() + M)) bajo = m + 1;
+        else if (std::lexicographical_compare(r.begin(), r.begin() + M, medio.begin(), medio.begin() + M)) alto = m;
+        else encontrado = true;
+    }
+    std::fclose(f);
+    return encontrado;
+}
+
+struct BusquedaExterna {
+    const Instancia& inst;
+    const ReglasExpansion& reglas;
+    const int M;
+    const std::string base; // prefijo de los ficheros de esta búsqueda
+    std::vector<EstadoCompacto> nivel; // pendientes y restante de cada profundidad
+    std::vector<std::map<int, long long>> cubetas; // por profundidad: f -> registros escritos
+    std::map<int, std::vector<int>> bufer_hijos;   // f -> cargas de los hijos a profundidad d+1
+    std::size_t bytes_hijos = 0;                   // capacidad reservada por 'bufer_hijos'
+    std::vector<std::string> creados;              // ficheros a borrar al terminar
+    std::vector<char> hay_cerrados;                // por profundidad: ya existe su fichero de cerrados
+    const PresupuestoExterno presupuesto;
+    EstadisticasBusqueda& contadores;
+    bool error = false;
+    std::string fallo; // el primer error de E/S
+
+    BusquedaExterna(const Instancia& inst_, const ReglasExpansion& reglas_, const std::string& base_,
+                    std::size_t memoria, EstadisticasBusqueda& contadores_)
+        : inst(inst_), reglas(reglas_), M(inst_.num_maquinas), base(base_), nivel(inst_.num_tareas + 1),
+          cubetas(inst_.num_tareas + 1), hay_cerrados(inst_.num_tareas + 1, 0), presupuesto(memoria, M),
+          contadores(contadores_) {
+        for (int d = inst.num_tareas - 1; d >= 0; --d) {
+            nivel[d] = nivel[d + 1];
+            nivel[d].pendientes[d >> 6] |= std::uint64_t{1} << (d & 63);
+            nivel[d].restante += inst.tiempos[d];
+        }
+    }
+    ~BusquedaExterna() {
+        for (const std::string& ruta : creados) std::remove(ruta.c_str());
+    }
+
+    std::string cubeta(int f, int d) const { return base + "f" + std::to_string(f) + "_d" + std::to_string(d); }
+    std::string cerrados(int d) const { return base + "c" + std::to_string(d); }
+    std::string temporal(const char* nombre) const { return base + nombre; }
+
+    // Abandona la búsqueda; 'que' describe el primer fallo.
+    void fallar(const std::string& que) {
+        if (!error) fallo = que;
+        error = true;
+    }
+
+    // Añade los hijos acumulados para f a su cubeta de profundidad d y
+    // devuelve la memoria del búfer.
+    void volcar(int f, int d, std::vector<int>& cargas) {
+        if (cargas.empty()) return;
+        std::string ruta = cubeta(f, d);
+        std::FILE* fichero = std::fopen(ruta.c_str(), "ab");
+        bool ok = fichero && std::fwrite(cargas.data(), sizeof(int), cargas.size(), fichero) == cargas.size();
+        if (fichero && std::fclose(fichero) != 0) ok = false;
+        if (!ok) fallar("no se puede escribir " + ruta);
+        auto [it, nueva] = cubetas[d].try_emplace(f, 0);
+        if (nueva) creados.push_back(ruta);
+        it->second += static_cast<long long>(cargas.size() / M);
+        std::vector<int>().swap(cargas);
+    }
+
+    // Vuelca un búfer de 'bufer_hijos' y descuenta su memoria de 'bytes_hijos'.
+    void volcarHijos(int f, int d, std::vector<int>& cargas) {
+        bytes_hijos -= cargas.capacity() * sizeof(int);
+        volcar(f, d, cargas);
+    }
+
+    // Vuelca el búfer de hijos más grande, para no pasar de 'presupuesto.hijos'.
+    void volcarMayor(int d) {
+        auto mayor = std::max_element(bufer_hijos.begin(), bufer_hijos.end(), [](const auto& a, const auto& b) {
+            return a.second.capacity() < b.second.capacity();
+        });
+        volcarHijos(mayor->first, d, mayor->second);
+    }
+
+    // Expande un estado de la cubeta (f, d). Devuelve true si genera una meta
+    // con f = f: no hay nada por debajo de f, así que es óptima.
+    bool expandir(const RegistroExterno& cargas, int f, int d, RegistroExterno& meta) {
+        CONTAR(++contadores.expandidos);
+        const int p = inst.tiempos[d];
+        for (int j = 0; j < M; ++j) {
+            if (j > 0 && cargas[j] == cargas[j - 1]) continue; // simetría
+            EstadoCompacto hijo = nivel[d + 1];
+            hijo.carga = cargas;
+            sumarCargaCanonica(hijo.carga.data(), j, p);
+            int f_hijo = std::max(f, calcularCotaInferior(inst, hijo, reglas.cota));
+            if (f_hijo >= reglas.f_limite) continue;
+            CONTAR(++contadores.generados);
+            if (d + 1 == inst.num_tareas && f_hijo == f) {
+                meta = hijo.carga;
+                return true;
+            }
+            std::vector<int>& destino = bufer_hijos[f_hijo];
+            const std::size_t antes = destino.capacity();
+            destino.insert(destino.end(), hijo.carga.begin(), hijo.carga.begin() + M);
+            bytes_hijos += (destino.capacity() - antes) * sizeof(int);
+            if (destino.size() * sizeof(int) >= presupuesto.bufer) volcarHijos(f_hijo, d + 1, destino);
+            while (bytes_hijos > presupuesto.hijos) volcarMayor(d + 1);
+        }
+        return false;
+    }
+
+    // Procesa la cubeta (f, d). Devuelve true si es la meta: 'meta' recibe un estado.
+    bool procesar(int f, int d, RegistroExterno& meta) {
+        cubetas[d].erase(f);
+        std::string entrada = cubeta(f, d), ordenada = temporal("ordenada"), nuevos = temporal("nuevos"),
+                    union_ = temporal("union");
+        if (!ordenarSinRepetidos(entrada, ordenada, M, presupuesto, contadores.duplicados))
+            fallar("no se puede ordenar " + entrada);
+        std::remove(entrada.c_str());
+        if (!error && !restarYUnir(ordenada, cerrados(d), hay_cerrados[d], nuevos, union_, M, presupuesto.bufer,
+                                   contadores.duplicados))
+            fallar("no se puede mezclar " + ordenada + " con " + cerrados(d));
+        std::remove(ordenada.c_str());
+        if (error) return false;
+        std::remove(cerrados(d).c_str()); // 'rename' no reemplaza en todas las plataformas
+        if (std::rename(union_.c_str(), cerrados(d).c_str()) != 0) {
+            fallar("no se puede renombrar " + union_);
+            return false;
+        }
+        hay_cerrados[d] = 1;
+
+        LectorRegistros lector(nuevos, M, presupuesto.bufer);
+        if (lector.error) {
+            fallar("no se puede abrir " + nuevos);
+            return false;
+        }
+        RegistroExterno cargas{};
+        bool meta_encontrada = false;
+        if (d == inst.num_tareas) {
+            meta_encontrada = lector.siguiente(meta);
+        } else {
+            while (!meta_encontrada && lector.siguiente(cargas)) meta_encontrada = expandir(cargas, f, d, meta);
+            if (!meta_encontrada)
+                for (auto& [f_hijo, bufer] : bufer_hijos) volcarHijos(f_hijo, d + 1, bufer);
+            bufer_hijos.clear();
+        }
+        if (lector.error) fallar("no se puede leer " + nuevos);
+        return meta_encontrada && !error;
+    }
+
+    // Menor f con alguna cubeta pendiente, o f_limite si no queda ninguna.
+    int siguienteF() const {
+        int f = reglas.f_limite;
+        for (const auto& porF : cubetas)
+            if (!porF.empty()) f = std::min(f, porF.begin()->first);
+        return f;
+    }
+
+    // Camino desde la raíz hasta 'meta', buscando hacia atrás predecesores cerrados.
+    std::vector<Movimiento> reconstruir(RegistroExterno estado) {
+        std::vector<Movimiento> camino;
+        for (int d = inst.num_tareas; d > 0; --d) {
+            const int p = inst.tiempos[d - 1];
+            bool encontrado = false;
+            for (int j = 0; j < M && !encontrado; ++j) {
+                if ((j > 0 && estado[j] == estado[j - 1]) || estado[j] < p) continue;
+                RegistroExterno padre = estado;
+                int valor = padre[j] - p;
+                int pos = j;
+                for (; pos + 1 < M && padre[pos + 1] > valor; ++pos) padre[pos] = padre[pos + 1];
+                padre[pos] = valor;
+                while (pos > 0 && padre[pos - 1] == valor) --pos; // la simetría elige la primera
+                bool error_lectura = false;
+                if (!contieneRegistro(cerrados(d - 1), M, padre, error_lectura)) {
+                    if (error_lectura) {
+                        fallar("no se puede leer " + cerrados(d - 1));
+                        return camino;
+                    }
+                    continue;
+                }
+                camino.push_back({static_cast<std::uint8_t>(d - 1), static_cast<std::uint8_t>(pos)});
+                estado = padre;
+                encontrado = true;
+            }
+            if (!encontrado) {
+                fallar("falta un predecesor en " + cerrados(d - 1));
+                return camino;
+            }
+        }
+        std::reverse(camino.begin(), camino.end());
+        return camino;
+    }
+};
+
+Estado A_estrella_externo(const Estado& estado_inicial, const OpcionesBusqueda& opciones) {
+    MedicionBusqueda medida(opciones.estadisticas);
+    OpcionesBusqueda opciones_externas = opciones;
+    opciones_externas.ramificacion = Ramificacion::OrdenFijo; // la profundidad indica las pendientes
+    PreparacionBusqueda prep;
+    if (!prepararBusqueda(estado_inicial, opciones_externas, prep)) return A_estrella_general(estado_inicial);
+    const Instancia& inst = prep.inst;
+    if (prep.incumbente.makespan <= prep.f_inicial) return estadoDesdeIncumbente(estado_inicial, inst, prep.incumbente);
+
+    // Prefijo único por búsqueda, para que varias puedan compartir directorio.
+    static std::atomic<unsigned> contador{0};
+    std::string base = std::string(opciones.directorio_externo) + "/pms_" +
+                       std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + "_" +
+                       std::to_string(contador++) + "_";
+    BusquedaExterna busqueda(inst, prep.reglas, base, opciones.memoria_externa, medida.datos);
+    for (int d = 0; d <= inst.num_tareas; ++d) busqueda.creados.push_back(busqueda.cerrados(d));
+    for (const char* t : {"ordenada", "nuevos", "union"}) busqueda.creados.push_back(busqueda.temporal(t));
+    CONTAR(medida.datos.bytes = busqueda.presupuesto.bytes);
+
+    std::vector<int> raiz(prep.raiz.carga.begin(), prep.raiz.carga.begin() + inst.num_maquinas);
+    busqueda.volcar(prep.f_inicial, 0, raiz);
+    RegistroExterno meta{};
+    for (int f = busqueda.siguienteF(); f < prep.reglas.f_limite && !busqueda.error; f = busqueda.siguienteF()) {
+        for (int d = 0; d <= inst.num_tareas && !busqueda.error; ++d) {
+            if (!busqueda.cubetas[d].count(f)) continue;
+            CONTAR(medida.datos.pico_abierta = std::max<std::size_t>(medida.datos.pico_abierta, busqueda.cubetas[d][f]));
+            if (busqueda.procesar(f, d, meta)) {
+                std::vector<Movimiento> camino = busqueda.reconstruir(meta);
+                if (!busqueda.error) return estadoDesdeMovimientos(estado_inicial, inst, prep.raiz.carga, camino);
+            }
+        }
+    }
+    // Sin cubetas por debajo de la cota superior, o error de disco (en 'opciones.error').
+    if (busqueda.error && opciones.error) *opciones.error = "A* externo: " + busqueda.fallo;
+    if (opciones.cota_superior) return estadoDesdeIncumbente(estado_inicial, inst, prep.incumbente);
+    return estado_inicial; // (no se encontró solución)
+}
+
+//--------------------------------
+// Algoritmo de Búsqueda: A*
+//--------------------------------
+/*
+  A* sobre la codificación compacta. Sigue el mismo esquema que
+  'A_estrella_general', pero los nodos viven en una arena: la cola guarda
+  índices, cada nodo solo recuerda a su padre y el 'Estado' con sus vectores
+  se reconstruye únicamente para la solución final.
+  La tabla hash guarda, para cada estado generado (abierto o cerrado), el
+  índice de su nodo. Un sucesor repetido no se vuelve a insertar: si no mejora
+  el g del nodo existente se descarta, y si lo mejora se actualiza el nodo en
+  su sitio (decrease-key) y se reinserta su índice en la cubeta de su nuevo f.
+  Antes de buscar se calcula una cota superior (LPT + MULTIFIT + búsqueda
+  local). Si la cota inferior de la raíz ya la alcanza, se devuelve sin
+  expandir ningún nodo; si no, los sucesores con f >= cota superior se
+  descartan al generarlos y, si la lista abierta se vacía, la solución
+  constructiva era óptima.
+  'buscarAEstrella' es el bucle de búsqueda especializado en MF (ver
+  "Especialización por número de máquinas"), sobre 'memoria.prep' ya
+  preparada; 'A_estrella' prepara y elige la especialización, o pasa al
+  modo en disco si 'opciones.directorio_externo' no es nulo.
+ */
+template <int MF>
+Estado buscarAEstrella(const Estado& estado_inicial, const OpcionesBusqueda& opciones, MemoriaBusqueda& memoria,
+                       [[maybe_unused]] MedicionBusqueda& medida) {
+    const PreparacionBusqueda& prep = memoria.prep;
+    const Instancia& inst = prep.inst;
+    const EstadoCompacto& raiz = prep.raiz;
+    const ReglasExpansion& reglas = prep.reglas;
+    const Incumbente& incumbente = prep.incumbente;
+    const int f_inicial = prep.f_inicial;
+    if (incumbente.makespan <= f_inicial) return estadoDesdeIncumbente(estado_inicial, inst, incumbente);
+
+    ArenaNodos<NodoArena>& arena = memoria.arena;
+    arena.vaciar();
+    TablaTransposicion& vistos = memoria.vistos; // clave -> índice del nodo
+    vistos.vaciar(opciones.memoria_cerrada);
+    std::vector<SucesorCompacto>& sucesores = memoria.sucesores;
+    sucesores.reserve(static_cast<size_t>(inst.num_tareas) * inst.num_maquinas);
+
+    int g_inicial = calcularCosteCompacto(inst, raiz);
+    ColaCubetas& abierta = memoria.abierta; // 'open'
+    abierta.vaciar(inst.carga_total);
+
+    std::uint32_t indice_raiz = arena.reservar({raiz, g_inicial, f_inicial, SIN_PADRE, 0, 0, false});
+    vistos.insertar(raiz.clave, static_cast<int>(indice_raiz), 0);
+    abierta.insertar(f_inicial, indice_raiz);
+
+    // En una carrera: el menor f de la lista abierta es cota inferior del óptimo.
+    int cota_anunciada = f_inicial;
+    long long pasos = 0;
+    bool cancelada = false;
+    while (!abierta.vacia()) {
+        CONTAR(medida.datos.pico_abierta = std::max(medida.datos.pico_abierta, abierta.tamano));
+        int f_cubeta;
+        std::uint32_t indice = [&] {
+            MEDIR_FASE(Fase::ExtraerAbierta);
+            return abierta.extraer(f_cubeta);
+        }();
+        NodoArena& actual = arena[indice];
+        // Entrada obsoleta: el nodo ya se expandió o se mejoró con otro f.
+        if (actual.cerrado || actual.f_cost != f_cubeta) continue;
+        if (f_cubeta > cota_anunciada) anunciarCotaInferior(opciones, cota_anunciada = f_cubeta);
+
+        // Meta: no quedan tareas pendientes.
+        if (sinTareasPendientes(actual.estado)) {
+            anunciarCotaSuperior(opciones, actual.g_cost);
+            CONTAR(medida.datos.bytes = memoria.bytes());
+            return reconstruirEstado(estado_inicial, inst, arena, indice);
+        }
+        if ((++pasos & (PASOS_ENTRE_CONSULTAS - 1)) == 0 && carreraDetenida(opciones)) {
+            cancelada = true;
+            break;
+        }
+        actual.cerrado = true;
+
+        generarSucesoresCompactos<MF>(inst, actual.estado, actual.f_cost, reglas, sucesores);
+        CONTAR(++medida.datos.expandidos);
+        CONTAR(medida.datos.generados += static_cast<long long>(sucesores.size()));
+        for (const auto& sucesor : sucesores) {
+            int g_sucesor = sucesor.g_cost;
+            int f_sucesor = sucesor.f_cost;
+            NodoArena hijo{sucesor.estado, g_sucesor, f_sucesor, indice,
+                           static_cast<std::uint8_t>(sucesor.tarea),
+                           static_cast<std::uint8_t>(sucesor.maquina), false};
+
+            auto mismo = [&](int v) { return arena[static_cast<std::uint32_t>(v)].estado == sucesor.estado; };
+            auto* visto = [&] {
+                MEDIR_FASE(Fase::Cerrada);
+                return vistos.buscar(sucesor.estado.clave, mismo);
+            }();
+            if (visto) {
+                NodoArena& existente = arena[static_cast<std::uint32_t>(visto->valor)];
+                CONTAR(++medida.datos.duplicados);
+                if (existente.g_cost <= g_sucesor) continue; // duplicado sin mejora
+                CONTAR(medida.datos.reaperturas += existente.cerrado);
+                existente = hijo;                            // mejora: se actualiza en su sitio
+                MEDIR_FASE(Fase::InsertarAbierta);
+                abierta.insertar(f_sucesor, static_cast<std::uint32_t>(visto->valor));
+                continue;
+            }
+            std::uint32_t indice_hijo = arena.reservar(hijo);
+            {
+                MEDIR_FASE(Fase::Cerrada);
+                vistos.insertar(sucesor.estado.clave, static_cast<int>(indice_hijo),
+                                tareasAsignadas(inst, sucesor.estado), mismo);
+            }
+            MEDIR_FASE(Fase::InsertarAbierta);
+            abierta.insertar(f_sucesor, indice_hijo);
+        }
+    }
+    // Lista abierta vacía: nada mejora a la solución constructiva.
+    CONTAR(medida.datos.bytes = memoria.bytes());
+    if (!cancelada) anunciarCotaInferior(opciones, reglas.f_limite);
+    if (opciones.cota_superior) return estadoDesdeIncumbente(estado_inicial, inst, incumbente);
+    return estado_inicial; // (no se encontró solución)
+}
+
+Estado A_estrella(const Estado& estado_inicial, const OpcionesBusqueda& opciones, MemoriaBusqueda& memoria) {
+    MEDIR_FASE(Fase::Busqueda);
+    if (opciones.directorio_externo) return A_estrella_externo(estado_inicial, opciones);
+    MedicionBusqueda medida(opciones.estadisticas);
+    if (!prepararBusqueda(estado_inicial, opciones, memoria.prep)) return A_estrella_general(estado_inicial);
+    return despacharMaquinas(memoria.prep.inst.num_maquinas, [&](auto mf) {
+        return buscarAEstrella<decltype(mf)::value>(estado_inicial, opciones, memoria, medida);
+    });
+}
+
+Estado A_estrella(const Estado& estado_inicial, const OpcionesBusqueda& opciones = OpcionesBusqueda{}) {
+    MemoriaBusqueda memoria; // se libera entera al salir de la función
+    return A_estrella(estado_inicial, opciones, memoria);
+}
+
+//--------------------------------
+// Algoritmo de Búsqueda: IDA*
+//--------------------------------
+/*
+  A* de profundización iterativa sobre f: búsqueda en profundidad que solo
+  sigue nodos con f <= umbral; si no encuentra la meta, repite con el menor f
+  que superó el umbral. La memoria es la pila de recursión (un EstadoCompacto
+  y un búfer de sucesores por nivel: O(profundidad·M) con OrdenFijo) más una
+  tabla de transposición de tamaño fijo ('memoria_transposicion').
+  La tabla guarda para cada estado el menor f por encima del umbral visto en
+  su subárbol. Como g y la cota solo dependen del estado, ese valor es una
+  cota válida venga de donde venga, y un estado con valor > umbral se poda.
+  Podar por una colisión de claves cortaría un subárbol que no se ha
+  explorado, así que cada entrada lleva también una comprobación
+  independiente de la clave (ver 'TablaCotas').
+  Como A*, se especializa en el número de máquinas MF.
+ */
+/*
+  Segunda huella de un estado, independiente de 'EstadoCompacto::clave': en
+  lugar de sumar, encadena con mezclar64 las cargas ordenadas y las palabras
+  de 'pendientes'. Dos estados distintos tendrían que coincidir a la vez en las
+  dos para confundirse.
+ */
+inline std::uint64_t comprobacionEstado(const int* carga, int M, const std::uint64_t* palabras, int num_palabras) {
+    std::uint64_t h = 0x243F6A8885A308D3ull;
+    for (int j = 0; j < M; ++j) h = mezclar64(h ^ static_cast<std::uint32_t>(carga[j]));
+    for (int w = 0; w < num_palabras; ++w) h = mezclar64(h ^ palabras[w]);
+    return h;
+}
+
+/*
+  Tabla de cotas de IDA*: la de 'TablaTransposicion' (sondeo lineal, tamaño
+  fijo con 'presupuesto_bytes' > 0 y reemplazo de la entrada más profunda),
+  pero cada entrada guarda además la 'comprobacion' del estado. 'buscar' solo
+  devuelve una entrada si coinciden la clave y la comprobación; 'insertar'
+  sobrescribe la del mismo estado o, si no está, ocupa un hueco.
+ */
+struct TablaCotas {
+    struct Entrada {
+        std::uint64_t clave = 0; // 0 = hueco libre
+        std::uint64_t comprobacion = 0;
+        int valor = 0;           // menor f por encima del umbral en el subárbol
+        int profundidad = 0;     // tareas ya asignadas en el estado
+    };
+    static constexpr int SONDEO_MAXIMO = 8;
+
+    std::vector<Entrada> entradas;
+    std::size_t mascara = 0;
+    std::size_t ocupadas = 0;
+    bool tamano_fijo = false;
+
+    explicit TablaCotas(std::size_t presupuesto_bytes) {
+        std::size_t capacidad = std::size_t{1} << 12;
+        tamano_fijo = presupuesto_bytes > 0;
+        if (tamano_fijo)
+            while (capacidad * 2 * sizeof(Entrada) <= presupuesto_bytes) capacidad *= 2;
+        entradas.assign(capacidad, Entrada{});
+        mascara = capacidad - 1;
+    }
+
+    std::size_t bytes() const { return entradas.capacity() * sizeof(Entrada); }
+
+    Entrada* buscar(std::uint64_t clave, std::uint64_t comprobacion) {
+        clave = TablaTransposicion::normalizar(clave);
+        std::size_t i = clave & mascara;
+        for (int s = 0; s < (tamano_fijo ? SONDEO_MAXIMO : static_cast<int>(entradas.size())); ++s) {
+            Entrada& e = entradas[(i + s) & mascara];
+            if (e.clave == clave && e.comprobacion == comprobacion) return &e;
+            if (e.clave == 0) return nullptr;
+        }
+        return nullptr;
+    }
+
+    void insertar(std::uint64_t clave, std::uint64_t comprobacion, int valor, int profundidad) {
+        if (!tamano_fijo && 2 * (ocupadas + 1) > entradas.size()) crecer();
+        clave = TablaTransposicion::normalizar(clave);
+        std::size_t i = clave & mascara;
+        Entrada* victima = nullptr;
+        for (std::size_t s = 0;; ++s) {
+            Entrada& e = entradas[(i + s) & mascara];
+            if ((e.clave == clave && e.comprobacion == comprobacion) || e.clave == 0) {
+                if (e.clave == 0) ++ocupadas;
+                e = {clave, comprobacion, valor, profundidad};
+                return;
+            }
+            if (tamano_fijo) {
+                if (!victima || e.profundidad > victima->profundidad) victima = &e;
+                if (s + 1 == SONDEO_MAXIMO) break;
+            }
+        }
+        *victima = {clave, comprobacion, valor, profundidad};
+    }
+
+    void crecer() {
+        std::vector<Entrada> antiguas(entradas.size() * 2);
+        antiguas.swap(entradas);
+        mascara = entradas.size() - 1;
+        for (const Entrada& e : antiguas) {
+            if (e.clave == 0) continue;
+            std::size_t i = e.clave & mascara;
+            while (entradas[i].clave != 0) i = (i + 1) & mascara;
+            entradas[i] = e;
+        }
+    }
+};
+
+template <int MF>
+struct BusquedaIDA {
+    static constexpr int ENCONTRADO = -1;
+
+    const Instancia& inst;
+    const ReglasExpansion& reglas;
+    TablaCotas tabla;
+    std::vector<std::vector<SucesorCompacto>> sucesores; // un búfer por profundidad
+    std::vector<Movimiento> camino;                      // movimientos desde la raíz
+    EstadisticasBusqueda& contadores;
+    const OpcionesBusqueda& opciones;
+    int umbral = 0;
+    long long pasos = 0;
+    bool cancelada = false; // parada de la carrera: se deshace la recursión sin resultado
+
+    BusquedaIDA(const Instancia& inst_, const ReglasExpansion& reglas_, const OpcionesBusqueda& opciones_,
+                EstadisticasBusqueda& contadores_)
+        : inst(inst_), reglas(reglas_), tabla(opciones_.memoria_transposicion), sucesores(inst_.num_tareas + 1),
+          contadores(contadores_), opciones(opciones_) {}
+
+    // Devuelve ENCONTRADO o el menor f que supera el umbral en el subárbol.
+    int buscar(const EstadoCompacto& estado, int f, int profundidad) {
+        if (f > umbral) return f;
+        if (sinTareasPendientes(estado)) return ENCONTRADO;
+        if ((++pasos & (PASOS_ENTRE_CONSULTAS - 1)) == 0 && carreraDetenida(opciones)) cancelada = true;
+        if (cancelada) return std::numeric_limits<int>::max();
+
+        const std::uint64_t comprobacion = comprobacionEstado(estado.carga.data(), numeroMaquinas<MF>(inst),
+                                                              estado.pendientes.data(), PALABRAS_TAREAS);
+        auto* entrada = tabla.buscar(estado.clave, comprobacion);
+        if (entrada && entrada->valor > umbral) {
+            CONTAR(++contadores.duplicados);
+            return entrada->valor;
+        }
+
+        std::vector<SucesorCompacto>& hijos = sucesores[profundidad];
+        generarSucesoresCompactos<MF>(inst, estado, f, reglas, hijos);
+        CONTAR(++contadores.expandidos);
+        CONTAR(contadores.generados += static_cast<long long>(hijos.size()));
+        std::sort(hijos.begin(), hijos.end(), [](const SucesorCompacto& a, const SucesorCompacto& b) {
+            return a.f_cost < b.f_cost;
+        });
+
+        int minimo = std::numeric_limits<int>::max();
+        for (const auto& hijo : hijos) {
+            camino.push_back({static_cast<std::uint8_t>(hijo.tarea), static_cast<std::uint8_t>(hijo.maquina)});
+            int r = buscar(hijo.estado, hijo.f_cost, profundidad + 1);
+            if (r == ENCONTRADO) return ENCONTRADO;
+            camino.pop_back();
+            minimo = std::min(minimo, r);
+        }
+        if (cancelada) return minimo; // subárbol sin terminar: no se guarda
+        tabla.insertar(estado.clave, comprobacion, minimo, profundidad);
+        return minimo;
+    }
+};
+
+/*
+  IDA* sin codificación compacta, para instancias de más de MAX_MAQUINAS
+  máquinas o de MAX_TAREAS tareas. El estado es el vector de cargas ordenadas
+  y la profundidad: las tareas se asignan siempre en orden LPT (como con
+  OrdenFijo), así que la profundidad dice cuáles quedan. Cada nivel guarda
+  su copia de las cargas y sus candidatos, O(n·M) en total, más la tabla de
+  cotas de tamaño fijo. Con las cargas ordenadas, la cota L2 de un hijo sale
+  en O(1) de la carga máxima, la mínima y las duraciones siguientes. De varias
+  máquinas con la misma carga solo se prueba la primera.
+ */
+struct BusquedaIDAAmplia {
+    static constexpr int ENCONTRADO = -1;
+
+    const PreparacionAmplia& prep;
+    const Instancia& inst;
+    const OpcionesBusqueda& opciones;
+    EstadisticasBusqueda& contadores;
+    const int M;
+    const int n;
+    const int cota_fija;  // max(media de carga, cota de la raíz): no cambia en toda la búsqueda
+    const int f_limite;   // makespan de la cota superior: los hijos que no bajan de él se descartan
+    TablaCotas tabla;
+    std::vector<int> cargas;                  // (n + 1)·M: cargas ordenadas de cada nivel
+    std::vector<std::pair<int, int>> hijos;   // n·M: (f, posición) de los candidatos de cada nivel
+    std::vector<int> camino;                  // camino[d]: posición que recibe la tarea d
+    int umbral = 0;
+    long long pasos = 0;
+    bool cancelada = false;
+
+    BusquedaIDAAmplia(const PreparacionAmplia& prep_, const OpcionesBusqueda& opciones_,
+                      EstadisticasBusqueda& contadores_)
+        : prep(prep_), inst(prep_.inst), opciones(opciones_), contadores(contadores_), M(inst.num_maquinas),
+          n(inst.num_tareas),
+          cota_fija(std::max((inst.carga_total + M - 1) / M, inst.cota_raiz)),
+          f_limite(prep_.incumbente.makespan), tabla(opciones_.memoria_transposicion),
+          cargas(static_cast<std::size_t>(n + 1) * M), hijos(static_cast<std::size_t>(n) * M), camino(n) {
+        std::copy(prep.carga.begin(), prep.carga.end(), cargas.begin());
+    }
+
+    static std::uint64_t claveProfundidad(int d) { return mezclar64(~static_cast<std::uint64_t>(d)); }
+
+    std::uint64_t claveRaiz() const {
+        std::uint64_t clave = claveProfundidad(0);
+        for (int j = 0; j < M; ++j) clave += mezclar64(cargas[j]);
+        return clave;
+    }
+
+    // Cota L2 de un estado de profundidad d con esas cargas máxima y mínima.
+    int cota(int d, int maximo, int minimo) const {
+        int f = std::max(maximo, cota_fija);
+        if (d < n) f = std::max(f, minimo + inst.tiempos[d]);
+        if (d + M < n) f = std::max(f, minimo + inst.tiempos[d + M - 1] + inst.tiempos[d + M]);
+        return f;
+    }
+
+    // Devuelve ENCONTRADO o el menor f que supera el umbral en el subárbol.
+    int buscar(int d, int f, std::uint64_t clave) {
+        if (f > umbral) return f;
+        if (d == n) return ENCONTRADO;
+        if ((++pasos & (PASOS_ENTRE_CONSULTAS - 1)) == 0 && carreraDetenida(opciones)) cancelada = true;
+        if (cancelada) return std::numeric_limits<int>::max();
+
+        int* c = &cargas[static_cast<std::size_t>(d) * M];
+        const std::uint64_t palabra = static_cast<std::uint64_t>(d);
+        const std::uint64_t comprobacion = comprobacionEstado(c, M, &palabra, 1);
+        auto* entrada = tabla.buscar(clave, comprobacion);
+        if (entrada && entrada->valor > umbral) {
+            CONTAR(++contadores.duplicados);
+            return entrada->valor;
+        }
+
+        CONTAR(++contadores.expandidos);
+        const int p = inst.tiempos[d];
+        std::pair<int, int>* h = &hijos[static_cast<std::size_t>(d) * M];
+        int k = 0;
+        for (int j = 0; j < M; ++j) {
+            if (j > 0 && c[j - 1] == c[j]) continue; // simetría: misma carga que la anterior
+            int nueva = c[j] + p;
+            int minimo = j < M - 1 ? c[M - 1] : (M > 1 ? std::min(c[M - 2], nueva) : nueva);
+            int f_hijo = cota(d + 1, std::max(c[0], nueva), minimo);
+            if (f_hijo >= f_limite) continue;
+            int a = k++;
+            for (; a > 0 && h[a - 1].first > f_hijo; --a) h[a] = h[a - 1];
+            h[a] = {f_hijo, j};
+        }
+        CONTAR(contadores.generados += k);
+
+        int minimo = std::numeric_limits<int>::max();
+        int* siguiente = c + M;
+        for (int a = 0; a < k; ++a) {
+            const int j = h[a].second;
+            std::copy_n(c, M, siguiente);
+            sumarCargaCanonica(siguiente, j, p);
+            camino[d] = j;
+            std::uint64_t clave_hijo = clave + mezclar64(c[j] + p) - mezclar64(c[j]) + claveProfundidad(d + 1) -
+                                       claveProfundidad(d);
+            int r = buscar(d + 1, h[a].first, clave_hijo);
+            if (r == ENCONTRADO) return ENCONTRADO;
+            minimo = std::min(minimo, r);
+        }
+        if (cancelada) return minimo; // subárbol sin terminar: no se guarda
+        tabla.insertar(clave, comprobacion, minimo, d);
+        return minimo;
+    }
+
+    // La solución del camino encontrado: se repite la reordenación de las cargas
+    // siguiendo qué máquina ocupa cada posición (ver 'estadoDesdeMovimientos').
+    Incumbente solucion() const {
+        std::vector<int> carga = prep.carga;
+        std::vector<int> maquina_en(M);
+        std::iota(maquina_en.begin(), maquina_en.end(), 0);
+        Incumbente sol;
+        sol.maquina_de.assign(n, 0);
+        for (int d = 0; d < n; ++d) {
+            const int j = camino[d];
+            sol.maquina_de[d] = maquina_en[j];
+            int destino = sumarCargaCanonica(carga.data(), j, inst.tiempos[d]);
+            std::rotate(maquina_en.begin() + destino, maquina_en.begin() + j, maquina_en.begin() + j + 1);
+        }
+        sol.makespan = carga[0];
+        return sol;
+    }
+};
+
+Estado IDA_estrella_amplio(const Estado& estado_inicial, const OpcionesBusqueda& opciones,
+                           EstadisticasBusqueda& datos) {
+    PreparacionAmplia prep;
+    if (!prepararAmplia(estado_inicial, opciones, prep)) return estado_inicial; // (sin máquinas)
+    if (prep.incumbente.makespan <= prep.f_inicial)
+        return estadoDesdeIncumbente(estado_inicial, prep.inst, prep.incumbente);
+
+    BusquedaIDAAmplia ida(prep, opciones, datos);
+    CONTAR(datos.bytes = ida.tabla.bytes() + (ida.cargas.capacity() + ida.camino.capacity()) * sizeof(int) +
+                         ida.hijos.capacity() * sizeof(std::pair<int, int>));
+    ida.umbral = prep.f_inicial;
+    const std::uint64_t clave = ida.claveRaiz();
+    while (ida.umbral < ida.f_limite) { // mismas garantías que en 'IDA_estrella'
+        anunciarCotaInferior(opciones, ida.umbral);
+        int r = ida.buscar(0, prep.f_inicial, clave);
+        if (r == BusquedaIDAAmplia::ENCONTRADO) {
+            anunciarCotaSuperior(opciones, ida.umbral);
+            return estadoDesdeIncumbente(estado_inicial, prep.inst, ida.solucion());
+        }
+        if (ida.cancelada || r == std::numeric_limits<int>::max()) break;
+        ida.umbral = r;
+    }
+    if (!ida.cancelada) anunciarCotaInferior(opciones, ida.f_limite);
+    if (opciones.cota_superior) return estadoDesdeIncumbente(estado_inicial, prep.inst, prep.incumbente);
+    return estado_inicial; // (no se encontró solución)
+}
+
+/*
+  Alternativa a 'A_estrella' con memoria acotada, para instancias en las que
+  la lista abierta y la cerrada no caben. Usa la misma preparación (cotas
+  inferior y superior) y devuelve una solución óptima. Las instancias de más
+  de MAX_MAQUINAS máquinas o MAX_TAREAS tareas pasan a 'BusquedaIDAAmplia',
+  también de memoria acotada. Con máquinas no idénticas no hay cargas que
+  ordenar: se devuelve el estado inicial y el motivo va a 'opciones.error'
+  (la ramificación y poda sí las resuelve).
+ */
+Estado IDA_estrella(const Estado& estado_inicial, const OpcionesBusqueda& opciones = OpcionesBusqueda{}) {
+    MedicionBusqueda medida(opciones.estadisticas);
+    if (modeloMaquinas(estado_inicial) != ModeloMaquinas::Identicas) {
+        if (opciones.error) *opciones.error = "IDA*: solo admite máquinas idénticas";
+        return estado_inicial;
+    }
+    PreparacionBusqueda prep;
+    if (!prepararBusqueda(estado_inicial, opciones, prep))
+        return IDA_estrella_amplio(estado_inicial, opciones, medida.datos);
+    if (prep.incumbente.makespan <= prep.f_inicial)
+        return estadoDesdeIncumbente(estado_inicial, prep.inst, prep.incumbente);
+
+    std::vector<Movimiento> camino;
+    bool encontrado = despacharMaquinas(prep.inst.num_maquinas, [&](auto mf) {
+        BusquedaIDA<decltype(mf)::value> ida(prep.inst, prep.reglas, opciones, medida.datos);
+        ida.camino.reserve(prep.inst.num_tareas);
+        CONTAR(medida.datos.bytes = ida.tabla.bytes());
+        ida.umbral = prep.f_inicial;
+        // Los f son enteros y cada iteración agota todos los f <= umbral, así que
+        // la primera meta encontrada tiene makespan igual al umbral: es óptima.
+        // Por lo mismo, al empezar cada iteración el umbral es cota inferior.
+        while (ida.umbral < prep.reglas.f_limite) {
+            anunciarCotaInferior(opciones, ida.umbral);
+            int r = ida.buscar(prep.raiz, prep.f_inicial, 0);
+            if (r == decltype(ida)::ENCONTRADO) {
+                anunciarCotaSuperior(opciones, ida.umbral);
+                camino = std::move(ida.camino);
+                return true;
+            }
+            if (ida.cancelada) return false;
+            if (r == std::numeric_limits<int>::max()) break; // nada por debajo de la cota superior
+            ida.umbral = r;
+        }
+        anunciarCotaInferior(opciones, prep.reglas.f_limite);
+        return false;
+    });
+    if (encontrado) return estadoDesdeMovimientos(estado_inicial, prep.inst, prep.raiz.carga, camino);
+    if (opciones.cota_superior) return estadoDesdeIncumbente(estado_inicial, prep.inst, prep.incumbente);
+    return estado_inicial; // (no se encontró solución)
+}
+
+//--------------------------------
+// Algoritmo de Búsqueda: ramificación y poda en profundidad
+//--------------------------------
+/*
+  Búsqueda en profundidad sin copias de estado: las cargas viven en un único
+  array indexado por la posición inicial de cada máquina, cada movimiento se
+  aplica en su sitio (carga += p) y se deshace al volver. Las tareas se
+  asignan de la más larga a la más corta y, en cada nodo, las máquinas se
+  prueban de menor a mayor carga, así que la primera hoja es la solución LPT.
+  Poda:
+  - Cota superior: un hijo cuya máquina llegaría al mejor makespan conocido
+    se descarta (y los siguientes, de carga mayor, también).
+  - Simetría: de varias máquinas con la misma carga (en particular, las
+    vacías) solo se prueba la primera.
+  - Espacio útil: el hueco de cada máquina hasta el mejor makespan menos uno
+    solo sirve si cabe la tarea más corta; si la suma de huecos útiles no
+    llega a lo que queda por asignar, el nodo no mejora la solución.
+  La búsqueda termina al agotar el árbol o al alcanzar la cota inferior del
+  óptimo. La memoria es O(n·M) y no depende del tamaño del árbol: las cargas
+  son un vector y no hace falta la codificación compacta, así que vale para
+  cualquier número de máquinas y de tareas.
+  En una carrera se poda también con la cota superior común y cada mejora se
+  publica; agotar el árbol demuestra que nada baja de la cota común final.
+  El modelo de máquinas es un parámetro de la plantilla (ver
+  'ModeloIdentico'): con máquinas no idénticas las máquinas se prueban por
+  instante de fin (carga + duración en esa máquina), la simetría solo vale
+  entre máquinas intercambiables y el espacio útil cuenta cada tarea por su
+  duración mínima ('inst.tiempos').
+ */
+/*
+  Modelos de máquinas de 'BusquedaProfundidad'. 'fila(t)' da lo que tarda la
+  tarea de índice t en cada máquina (fila(t)[j]) e 'intercambiables(a, b)'
+  dice si dos máquinas con la misma carga dan subárboles equivalentes.
+  Con máquinas idénticas la fila es un valor fijo, así que el compilador
+  genera el mismo bucle que sin modelo.
+ */
+struct ModeloIdentico {
+    struct Fila {
+        int p;
+        int operator[](int) const { return p; }
+    };
+    const int* tiempos;
+    Fila fila(int tarea) const { return {tiempos[tarea]}; }
+    bool intercambiables(int, int) const { return true; }
+};
+
+// Uniformes (velocidades) o no relacionadas: filas de una 'MatrizTiempos' por índice de tarea.
+template <bool UNIFORMES>
+struct ModeloMatriz {
+    const MatrizTiempos* tiempos;
+    const int* velocidad; // solo con UNIFORMES
+    const int* fila(int tarea) const { return tiempos->fila(tarea); }
+    bool intercambiables(int a, int b) const { return UNIFORMES && velocidad[a] == velocidad[b]; }
+};
+
+template <int MF, typename Modelo = ModeloIdentico>
+struct BusquedaProfundidad {
+    const Instancia& inst;
+    const Modelo modelo;
+    const int M;
+    const std::vector<int> orden;            // tareas de mayor a menor duración
+    const int p_min;                         // duración de la tarea más corta
+    const int cota_optimo;                   // no hay solución por debajo
+    std::vector<int> carga;                  // carga por posición inicial de máquina
+    std::vector<int> maquina_de;             // asignación en curso
+    std::vector<int> candidatos;             // M posiciones por profundidad
+    Incumbente& mejor;
+    EstadisticasBusqueda& contadores;
+    CarreraMotores* carrera;
+    long long pasos = 0;
+    bool terminado = false;
+    bool cancelada = false;
+
+    BusquedaProfundidad(const Instancia& inst_, const Modelo& modelo_, const int* carga_inicial, int cota_optimo_,
+                        Incumbente& mejor_, EstadisticasBusqueda& contadores_, CarreraMotores* carrera_)
+        : inst(inst_), modelo(modelo_), M(numeroMaquinas<MF>(inst_)), orden(tareasPorDuracion(inst_)),
+          p_min(orden.empty() ? 0 : inst_.tiempos[orden.back()]), cota_optimo(cota_optimo_),
+          carga(carga_inicial, carga_inicial + M), maquina_de(inst_.num_tareas, 0),
+          candidatos(static_cast<std::size_t>(inst_.num_tareas) * M), mejor(mejor_), contadores(contadores_),
+          carrera(carrera_) {}
+
+    // Makespan que hay que mejorar: el propio o, en una carrera, el común si es menor.
+    int limiteActual() const {
+        if (!carrera) return mejor.makespan;
+        return std::min(mejor.makespan, carrera->cota_superior.load(std::memory_order_relaxed));
+    }
+
+    void buscar(int profundidad, int makespan, int restante) {
+        if (profundidad == inst.num_tareas) {
+            if (makespan < mejor.makespan) {
+                mejor.makespan = makespan;
+                mejor.maquina_de = maquina_de;
+                terminado = makespan <= cota_optimo;
+                if (carrera) carrera->mejorarSuperior(makespan);
+            }
+            return;
+        }
+        CONTAR(++contadores.expandidos);
+        if (carrera && (++pasos & (PASOS_ENTRE_CONSULTAS - 1)) == 0 && carrera->detenida())
+            terminado = cancelada = true;
+        if (terminado) return;
+        const int limite = limiteActual(); // toda carga debe quedar por debajo
+        if (limite != std::numeric_limits<int>::max()) {
+            long long util = 0;
+            for (int j = 0; j < M; ++j) {
+                int hueco = limite - 1 - carga[j];
+                if (hueco >= p_min) util += hueco;
+            }
+            if (util < restante) return;
+        }
+
+        const int tarea = orden[profundidad];
+        const auto p = modelo.fila(tarea); // p[j]: duración en la máquina j
+        int* cand = &candidatos[static_cast<std::size_t>(profundidad) * M];
+        int k = 0;
+        for (int j = 0; j < M; ++j) {
+            int c = carga[j];
+            int fin = c + p[j];
+            if (fin >= limite) continue;
+            bool repetida = false;
+            for (int a = 0; a < k && !repetida; ++a)
+                repetida = carga[cand[a]] == c && modelo.intercambiables(cand[a], j);
+            if (repetida) continue;
+            int a = k++;
+            for (; a > 0 && carga[cand[a - 1]] + p[cand[a - 1]] > fin; --a) cand[a] = cand[a - 1];
+            cand[a] = j;
+        }
+
+        for (int a = 0; a < k && !terminado; ++a) {
+            int j = cand[a];
+            if (carga[j] + p[j] >= limiteActual()) break; // la cota superior ha bajado
+            CONTAR(++contadores.generados);
+            carga[j] += p[j];
+            maquina_de[tarea] = j;
+            buscar(profundidad + 1, std::max(makespan, carga[j]), restante - inst.tiempos[tarea]);
+            carga[j] -= p[j];
+        }
+    }
+};
+
+/*
+  'ramificacionYPoda' con máquinas uniformes o no relacionadas, sobre una
+  'InstanciaModelo': parte de la solución ECT y de 'cotaInferiorModelo' y
+  se especializa en el número de máquinas y en el modelo.
+ */
+Estado ramificacionYPodaModelo(const Estado& estado_inicial, const OpcionesBusqueda& opciones) {
+    if (estado_inicial.M.empty()) return estado_inicial; // (sin máquinas no hay solución)
+    MedicionBusqueda medida(opciones.estadisticas);
+    InstanciaModelo im;
+    prepararModelo(estado_inicial, im);
+    const int cota_optimo = std::max(cotaInferiorModelo(im), opciones.cota_inferior_previa);
+    Incumbente mejor;
+    if (opciones.cota_superior) {
+        mejor = planificarECT(im);
+        anunciarCotaSuperior(opciones, mejor.makespan);
+    }
+    anunciarCotaInferior(opciones, cota_optimo);
+    if (mejor.makespan <= cota_optimo) return estadoDesdeIncumbente(estado_inicial, im.inst, mejor);
+
+    const int makespan_inicial = *std::max_element(im.carga.begin(), im.carga.end());
+    int restante = 0;
+    for (int p : im.inst.tiempos) restante += p;
+    despacharMaquinas(im.inst.num_maquinas, [&](auto mf) {
+        auto buscar = [&](auto modelo) {
+            BusquedaProfundidad<decltype(mf)::value, decltype(modelo)> busqueda(im.inst, modelo, im.carga.data(),
+                                                                                cota_optimo, mejor, medida.datos,
+                                                                                opciones.carrera);
+            CONTAR(medida.datos.bytes = (busqueda.carga.capacity() + busqueda.candidatos.capacity() +
+                                         busqueda.maquina_de.capacity() + busqueda.orden.capacity()) * sizeof(int) +
+                                        im.tiempos.lineas.capacity() * sizeof(MatrizTiempos::LineaCache));
+            busqueda.buscar(0, makespan_inicial, restante);
+            if (!busqueda.cancelada) anunciarCotaInferior(opciones, busqueda.limiteActual());
+        };
+        if (im.modelo == ModeloMaquinas::Uniformes) buscar(ModeloMatriz<true>{&im.tiempos, im.velocidad.data()});
+        else buscar(ModeloMatriz<false>{&im.tiempos, nullptr});
+    });
+    if (mejor.maquina_de.empty()) return estado_inicial; // (no se encontró solución)
+    return estadoDesdeIncumbente(estado_inicial, im.inst, mejor);
+}
+
+// 'ramificacionYPoda' sobre una 'PreparacionAmplia': tareas en orden LPT y sin especializar en MF.
+Estado ramificacionYPodaAmplia(const Estado& estado_inicial, const OpcionesBusqueda& opciones,
+                               EstadisticasBusqueda& datos) {
+    PreparacionAmplia prep;
+    if (!prepararAmplia(estado_inicial, opciones, prep)) return estado_inicial; // (sin máquinas)
+    Incumbente& mejor = prep.incumbente;
+    if (mejor.makespan <= prep.f_inicial) return estadoDesdeIncumbente(estado_inicial, prep.inst, mejor);
+
+    BusquedaProfundidad<0> busqueda(prep.inst, ModeloIdentico{prep.inst.tiempos.data()}, prep.carga.data(),
+                                    prep.f_inicial, mejor, datos, opciones.carrera);
+    CONTAR(datos.bytes = (busqueda.carga.capacity() + busqueda.candidatos.capacity() +
+                          busqueda.maquina_de.capacity() + busqueda.orden.capacity()) * sizeof(int));
+    busqueda.buscar(0, prep.carga[0], std::accumulate(prep.inst.tiempos.begin(), prep.inst.tiempos.end(), 0));
+    if (!busqueda.cancelada) anunciarCotaInferior(opciones, busqueda.limiteActual());
+    if (mejor.maquina_de.empty()) return estado_inicial; // (no se encontró solución)
+    return estadoDesdeIncumbente(estado_inicial, prep.inst, mejor);
+}
+
+/*
+  Motor exacto de memoria constante. Usa la misma preparación que A* (cota
+  superior de partida y cota inferior de la raíz) y devuelve una solución
+  óptima. En instancias ajustadas, donde LPT/MULTIFIT dejan poco hueco, la
+  poda por espacio útil corta el árbol muy arriba. Con máquinas uniformes o
+  no relacionadas pasa a 'ramificacionYPodaModelo'; fuera de los límites de
+  la codificación compacta se prepara con 'prepararAmplia'.
+ */
+Estado ramificacionYPoda(const Estado& estado_inicial, const OpcionesBusqueda& opciones = OpcionesBusqueda{}) {
+    if (modeloMaquinas(estado_inicial) != ModeloMaquinas::Identicas)
+        return ramificacionYPodaModelo(estado_inicial, opciones);
+    MedicionBusqueda medida(opciones.estadisticas);
+    PreparacionBusqueda prep;
+    if (!prepararBusqueda(estado_inicial, opciones, prep))
+        return ramificacionYPodaAmplia(estado_inicial, opciones, medida.datos);
+    Incumbente& mejor = prep.incumbente;
+    const int cota_optimo = std::max(prep.f_inicial, prep.inst.cota_raiz);
+    if (mejor.makespan <= cota_optimo) return estadoDesdeIncumbente(estado_inicial, prep.inst, mejor);
+
+    despacharMaquinas(prep.inst.num_maquinas, [&](auto mf) {
+        BusquedaProfundidad<decltype(mf)::value> busqueda(prep.inst, ModeloIdentico{prep.inst.tiempos.data()},
+                                                          prep.raiz.carga.data(), cota_optimo, mejor, medida.datos,
+                                                          opciones.carrera);
+        CONTAR(medida.datos.bytes = (busqueda.carga.capacity() + busqueda.candidatos.capacity() +
+                                     busqueda.maquina_de.capacity() + busqueda.orden.capacity()) * sizeof(int));
+        busqueda.buscar(0, prep.raiz.carga[0], prep.raiz.restante);
+        if (!busqueda.cancelada) anunciarCotaInferior(opciones, busqueda.limiteActual());
+    });
+    if (mejor.maquina_de.empty()) return estado_inicial; // (no se encontró solución)
+    return estadoDesdeIncumbente(estado_inicial, prep.inst, mejor);
+}
+
+//--------------------------------
+// Algoritmo de Búsqueda: A* paralelo (HDA*)
+//--------------------------------
+/*
+  Hash Distributed A*: cada hilo es dueño de la parte del espacio de estados
+  cuyas claves le asigna 'duenoDe', con su propia arena, tabla de vistos y
+  lista abierta. Los sucesores se envían al hilo dueño en lotes a través de
+  colas MPSC sin bloqueos; así cada estado solo se comprueba contra duplicados
+  en un hilo y ninguna estructura de búsqueda se comparte.
+  La cota superior (incumbente) sí es común: un atómico con el mejor makespan.
+  Terminación: 'trabajo' cuenta mensajes en vuelo más entradas de las listas
+  abiertas. Un hilo suma los hijos de un nodo antes de restar el nodo, así que
+  el contador solo llega a cero cuando ningún hilo conserva un nodo con f por
+  debajo del incumbente; en ese momento el incumbente es óptimo.
+  Memoria: cada hilo construye su 'Trabajador' (arena por bloques, tabla,
+  cubetas) dentro de su propio hilo antes de empezar, así que con la política
+  de primer contacto del sistema sus páginas quedan en el nodo NUMA del hilo.
+  Los lotes de mensajes no vuelven al reservador global: quien recibe un lote
+  lo guarda en su reserva de lotes libres y lo reutiliza para sus envíos.
+ */
+constexpr std::uint64_t SIN_PADRE_HDA = ~std::uint64_t{0};
+
+// Referencia a un nodo de otro hilo: (hilo << 32) | índice en su arena.
+inline std::uint64_t referenciaHDA(int hilo, std::uint32_t indice) {
+    return (static_cast<std::uint64_t>(hilo) << 32) | indice;
+}
+
+struct NodoHDA {
+    EstadoCompacto estado;
+    int g_cost;
+    int f_cost;
+    std::uint64_t padre;
+    std::uint8_t tarea;
+    std::uint8_t maquina;
+    bool cerrado;
+};
+
+struct LoteHDA {
+    static constexpr std::size_t CAPACIDAD = 64;
+    std::atomic<LoteHDA*> siguiente{nullptr};
+    std::vector<NodoHDA> mensajes;
+};
+
+/*
+  Cola intrusiva de varios productores y un consumidor (algoritmo de Vyukov).
+  'insertar' es un único intercambio atómico; 'extraer' solo lo llama el hilo
+  dueño y puede devolver nullptr mientras un productor está a medio insertar.
+ */
+struct ColaMPSC {
+    LoteHDA nodo_vacio;
+    std::atomic<LoteHDA*> cabeza;
+    LoteHDA* cola;
+
+    ColaMPSC() : cabeza(&nodo_vacio), cola(&nodo_vacio) {}
+
+    void insertar(LoteHDA* lote) {
+        lote->siguiente.store(nullptr, std::memory_order_relaxed);
+        LoteHDA* anterior = cabeza.exchange(lote, std::memory_order_acq_rel);
+        anterior->siguiente.store(lote, std::memory_order_release);
+    }
+
+    LoteHDA* extraer() {
+        LoteHDA* primero = cola;
+        LoteHDA* siguiente = primero->siguiente.load(std::memory_order_acquire);
+        if (primero == &nodo_vacio) {
+            if (!siguiente) return nullptr;
+            cola = siguiente;
+            primero = siguiente;
+            siguiente = siguiente->siguiente.load(std::memory_order_acquire);
+        }
+        if (siguiente) {
+            cola = siguiente;
+            return primero;
+        }
+        if (primero != cabeza.load(std::memory_order_acquire)) return nullptr;
+        insertar(&nodo_vacio);
+        siguiente = primero->siguiente.load(std::memory_order_acquire);
+        if (siguiente) {
+            cola = siguiente;
+            return primero;
+        }
+        return nullptr;
+    }
+};
+
+struct BusquedaHDA {
+    struct alignas(64) Trabajador {
+        ArenaNodos<NodoHDA> arena;
+        TablaTransposicion vistos;
+        ColaCubetas abierta;
+        ColaMPSC buzon;
+        std::vector<LoteHDA*> salida;       // lote en construcción por hilo destino
+        std::vector<LoteHDA*> lotes_libres; // lotes recibidos, para reutilizar en los envíos
+        std::size_t lotes_creados = 0;
+        std::vector<SucesorCompacto> sucesores;
+        long long restas_pendientes = 0; // descuentos de 'trabajo' aún no aplicados
+        EstadisticasBusqueda contadores;
+
+        Trabajador(std::size_t memoria, int f_maximo, int hilos) : vistos(memoria), abierta(f_maximo), salida(hilos, nullptr) {}
+
+        MemoriaHilo memoria() const {
+            std::size_t lote = sizeof(LoteHDA) + LoteHDA::CAPACIDAD * sizeof(NodoHDA);
+            return {arena.bytes(), vistos.bytes(), abierta.bytes(),
+                    lotes_creados * lote + sucesores.capacity() * sizeof(SucesorCompacto)};
+        }
+    };
+
+    const Instancia& inst;
+    const ReglasExpansion& reglas;
+    const OpcionesBusqueda& opciones;
+    int num_hilos;
+    std::size_t memoria_por_hilo;
+    NodoHDA raiz;
+    std::vector<std::unique_ptr<Trabajador>> trabajadores;
+    std::atomic<int> listos{0}; // trabajadores ya construidos
+    alignas(64) std::atomic<int> incumbente; // se lee en cada expansión: línea propia
+    alignas(64) std::atomic<long long> trabajo{0};
+    alignas(64) std::mutex mutex_meta;
+    std::uint64_t meta = SIN_PADRE_HDA; // nodo meta del incumbente (si lo encontró la búsqueda)
+
+    BusquedaHDA(const Instancia& inst_, const ReglasExpansion& reglas_, const OpcionesBusqueda& opciones_, int hilos,
+                const NodoHDA& raiz_)
+        : inst(inst_), reglas(reglas_), opciones(opciones_), num_hilos(hilos),
+          memoria_por_hilo(opciones_.memoria_cerrada / hilos), raiz(raiz_),
+          trabajadores(hilos), incumbente(reglas_.f_limite), trabajo(1) {}
+
+    ~BusquedaHDA() {
+        for (auto& t : trabajadores) {
+            if (!t) continue;
+            for (LoteHDA* lote : t->salida) delete lote;
+            for (LoteHDA* lote : t->lotes_libres) delete lote;
+            while (LoteHDA* lote = t->buzon.extraer()) delete lote;
+        }
+    }
+
+    int duenoDe(std::uint64_t clave) const {
+        return static_cast<int>((clave >> 40) % static_cast<std::uint64_t>(num_hilos));
+    }
+
+    void enviar(int origen, const NodoHDA& nodo) {
+        Trabajador& t = *trabajadores[origen];
+        int destino = duenoDe(nodo.estado.clave);
+        LoteHDA*& lote = t.salida[destino];
+        if (!lote && !t.lotes_libres.empty()) {
+            lote = t.lotes_libres.back();
+            t.lotes_libres.pop_back();
+        } else if (!lote) {
+            lote = new LoteHDA;
+            lote->mensajes.reserve(LoteHDA::CAPACIDAD);
+            ++t.lotes_creados;
+        }
+        lote->mensajes.push_back(nodo);
+        if (lote->mensajes.size() == LoteHDA::CAPACIDAD) {
+            trabajadores[destino]->buzon.insertar(lote);
+            lote = nullptr;
+        }
+    }
+
+    void vaciarSalida(int origen) {
+        Trabajador& t = *trabajadores[origen];
+        for (int destino = 0; destino < num_hilos; ++destino) {
+            if (!t.salida[destino]) continue;
+            trabajadores[destino]->buzon.insertar(t.salida[destino]);
+            t.salida[destino] = nullptr;
+        }
+        if (t.restas_pendientes) {
+            trabajo.fetch_sub(t.restas_pendientes, std::memory_order_acq_rel);
+            t.restas_pendientes = 0;
+        }
+    }
+
+    // Un mensaje recibido pasa a la lista abierta o se descarta (restando de 'trabajo').
+    void recibir(Trabajador& t, const NodoHDA& nodo) {
+        if (nodo.f_cost >= incumbente.load(std::memory_order_relaxed)) {
+            ++t.restas_pendientes;
+            return;
+        }
+        auto mismo = [&](int v) { return t.arena[static_cast<std::uint32_t>(v)].estado == nodo.estado; };
+        auto* visto = t.vistos.buscar(nodo.estado.clave, mismo);
+        if (visto) {
+            NodoHDA& existente = t.arena[static_cast<std::uint32_t>(visto->valor)];
+            CONTAR(++t.contadores.duplicados);
+            if (existente.g_cost <= nodo.g_cost) {
+                ++t.restas_pendientes;
+                return;
+            }
+            CONTAR(t.contadores.reaperturas += existente.cerrado);
+            existente = nodo;
+            t.abierta.insertar(nodo.f_cost, static_cast<std::uint32_t>(visto->valor));
+            return;
+        }
+        std::uint32_t indice = t.arena.reservar(nodo);
+        t.vistos.insertar(nodo.estado.clave, static_cast<int>(indice), tareasAsignadas(inst, nodo.estado), mismo);
+        t.abierta.insertar(nodo.f_cost, indice);
+        CONTAR(t.contadores.pico_abierta = std::max(t.contadores.pico_abierta, t.abierta.tamano));
+    }
+
+    void registrarMeta(int hilo, std::uint32_t indice, int makespan) {
+        std::lock_guard<std::mutex> lock(mutex_meta);
+        if (makespan >= incumbente.load()) return;
+        incumbente.store(makespan);
+        meta = referenciaHDA(hilo, indice);
+        anunciarCotaSuperior(opciones, makespan);
+    }
+
+    void ejecutar(int yo) {
+        // Primer contacto: la memoria del trabajador se reserva y se escribe en su hilo.
+        trabajadores[yo].reset(new Trabajador(memoria_por_hilo, inst.carga_total, num_hilos));
+        Trabajador& t = *trabajadores[yo];
+        listos.fetch_add(1, std::memory_order_acq_rel);
+        while (listos.load(std::memory_order_acquire) < num_hilos) std::this_thread::yield();
+        if (duenoDe(raiz.estado.clave) == yo) recibir(t, raiz);
+
+        ReglasExpansion reglas_locales = reglas;
+        int expansiones = 0;
+        while (true) {
+            while (LoteHDA* lote = t.buzon.extraer()) {
+                for (const NodoHDA& nodo : lote->mensajes) recibir(t, nodo);
+                lote->mensajes.clear();
+                t.lotes_libres.push_back(lote);
+            }
+            if (t.abierta.vacia()) {
+                vaciarSalida(yo);
+                if (trabajo.load(std::memory_order_acquire) == 0) return;
+                std::this_thread::yield();
+                continue;
+            }
+
+            int f_cubeta;
+            std::uint32_t indice = t.abierta.extraer(f_cubeta);
+            NodoHDA& actual = t.arena[indice];
+            int cota_superior = incumbente.load(std::memory_order_relaxed);
+            if (actual.cerrado || actual.f_cost != f_cubeta || f_cubeta >= cota_superior) {
+                ++t.restas_pendientes;
+                continue;
+            }
+            actual.cerrado = true;
+            if (sinTareasPendientes(actual.estado)) {
+                registrarMeta(yo, indice, actual.g_cost);
+                ++t.restas_pendientes;
+                continue;
+            }
+
+            reglas_locales.f_limite = cota_superior;
+            generarSucesoresCompactos(inst, actual.estado, actual.f_cost, reglas_locales, t.sucesores);
+            CONTAR(++t.contadores.expandidos);
+            CONTAR(t.contadores.generados += static_cast<long long>(t.sucesores.size()));
+            // Los hijos se cuentan antes de restar el padre: una sola operación atómica.
+            trabajo.fetch_add(static_cast<long long>(t.sucesores.size()) - 1, std::memory_order_acq_rel);
+            std::uint64_t padre = referenciaHDA(yo, indice);
+            for (const auto& sucesor : t.sucesores) {
+                NodoHDA hijo{sucesor.estado, sucesor.g_cost, sucesor.f_cost, padre,
+                             static_cast<std::uint8_t>(sucesor.tarea),
+                             static_cast<std::uint8_t>(sucesor.maquina), false};
+                if (duenoDe(sucesor.estado.clave) == yo) recibir(t, hijo);
+                else enviar(yo, hijo);
+            }
+            if (++expansiones % 32 == 0) vaciarSalida(yo);
+            // Parada de la carrera: con incumbente mínimo todo nodo se descarta y
+            // 'trabajo' se vacía por la vía normal de terminación.
+            if (expansiones % PASOS_ENTRE_CONSULTAS == 0 && carreraDetenida(opciones))
+                incumbente.store(std::numeric_limits<int>::min());
+        }
+    }
+
+    // Camino de movimientos desde la raíz hasta 'meta' (tras terminar todos los hilos).
+    std::vector<Movimiento> camino() const {
+        std::vector<Movimiento> movimientos;
+        for (std::uint64_t ref = meta;;) {
+            const NodoHDA& nodo = trabajadores[ref >> 32]->arena[static_cast<std::uint32_t>(ref)];
+            if (nodo.padre == SIN_PADRE_HDA) break;
+            movimientos.push_back({nodo.tarea, nodo.maquina});
+            ref = nodo.padre;
+        }
+        std::reverse(movimientos.begin(), movimientos.end());
+        return movimientos;
+    }
+};
+
+/*
+  Versión paralela de 'A_estrella' con 'opciones.hilos' hilos. Devuelve una
+  solución óptima, igual que la secuencial.
+ */
+Estado HDA_estrella(const Estado& estado_inicial, const OpcionesBusqueda& opciones = OpcionesBusqueda{}) {
+    MedicionBusqueda medida(opciones.estadisticas);
+    PreparacionBusqueda prep;
+    if (!prepararBusqueda(estado_inicial, opciones, prep)) return A_estrella_general(estado_inicial);
+    if (prep.incumbente.makespan <= prep.f_inicial)
+        return estadoDesdeIncumbente(estado_inicial, prep.inst, prep.incumbente);
+
+    int hilos = hilosEfectivos(opciones);
+    NodoHDA raiz{prep.raiz, calcularCosteCompacto(prep.inst, prep.raiz), prep.f_inicial, SIN_PADRE_HDA, 0, 0, false};
+    BusquedaHDA hda(prep.inst, prep.reglas, opciones, hilos, raiz);
+
+    std::vector<std::thread> pool;
+    for (int h = 0; h < hilos; ++h) pool.emplace_back(&BusquedaHDA::ejecutar, &hda, h);
+    for (auto& hilo : pool) hilo.join();
+#if ESTADISTICAS_BUSQUEDA
+    for (const auto& t : hda.trabajadores) {
+        medida.datos.acumular(t->contadores);
+        medida.datos.memoria_hilos.push_back(t->memoria());
+        medida.datos.bytes += medida.datos.memoria_hilos.back().total();
+    }
+#endif
+
+    if (hda.meta != SIN_PADRE_HDA)
+        return estadoDesdeMovimientos(estado_inicial, prep.inst, prep.raiz.carga, hda.camino());
+    if (opciones.cota_superior) return estadoDesdeIncumbente(estado_inicial, prep.inst, prep.incumbente);
+    return estado_inicial; // (no se encontró solución)
+}
+
+//--------------------------------
+// Modo anytime: A* ponderado con peso decreciente
+//--------------------------------
+/*
+  Para cuando importa tener una buena planificación antes de un plazo más que
+  demostrar el óptimo. Se ejecutan búsquedas A* ponderadas (prioridad
+  g + w·h, con h = f - g) con pesos cada vez menores, reiniciando la búsqueda
+  en cada peso y podando con el mejor makespan encontrado hasta el momento.
+  Cada mejora se entrega a 'al_mejorar' junto con la cota inferior probada:
+  - la cota de la raíz, y
+  - si una búsqueda con peso w termina en una meta de coste c, el óptimo no
+    baja de c / w (garantía de A* ponderado con h admisible).
+  Si una búsqueda vacía su lista abierta, o termina con w = 1, el incumbente
+  es óptimo; si eso ocurre sin mejorar la solución, 'al_mejorar' se llama una
+  última vez con la misma solución y la cota igual al makespan.
+  Los pesos son fracciones peso / PESO_BASE.
+ */
+using CallbackMejora = std::function<void(const Estado& solucion, int makespan, int cota_inferior)>;
+
+struct BusquedaPonderada {
+    static constexpr int PESO_BASE = 8;
+    static constexpr int PESOS[] = {24, 16, 12, 10, 9, 8}; // 3, 2, 1.5, 1.25, 1.125, 1
+
+    struct Entrada {
+        long long prioridad;
+        int g_cost;
+        std::uint32_t nodo;
+        bool operator>(const Entrada& other) const {
+            // A igual prioridad, primero el de mayor g (más cerca de una meta).
+            if (prioridad != other.prioridad) return prioridad > other.prioridad;
+            return g_cost < other.g_cost;
+        }
+    };
+
+    enum class Resultado { Meta, Agotada, SinTiempo };
+};
+
+/*
+  Motor anytime. 'presupuesto_s' es el plazo en segundos desde la llamada;
+  al vencer se devuelve la mejor solución encontrada.
+ */
+Estado A_estrella_anytime(const Estado& estado_inicial, double presupuesto_s, const CallbackMejora& al_mejorar,
+                          const OpcionesBusqueda& opciones = OpcionesBusqueda{}) {
+    using Reloj = std::chrono::steady_clock;
+    const auto limite = Reloj::now() + std::chrono::duration_cast<Reloj::duration>(
+                                           std::chrono::duration<double>(presupuesto_s));
+    MedicionBusqueda medida(opciones.estadisticas); // suma de todas las búsquedas ponderadas
+
+    OpcionesBusqueda opciones_prep = opciones;
+    opciones_prep.cota_superior = true; // el modo anytime siempre parte de una solución
+    PreparacionBusqueda prep;
+    if (!prepararBusqueda(estado_inicial, opciones_prep, prep)) {
+        Estado solucion = A_estrella_general(estado_inicial);
+        if (al_mejorar) al_mejorar(solucion, calcularCoste(solucion), calcularCoste(solucion));
+        return solucion;
+    }
+    const Instancia& inst = prep.inst;
+    int cota_inferior = prep.f_inicial;
+    Estado mejor = estadoDesdeIncumbente(estado_inicial, inst, prep.incumbente);
+    int makespan = prep.incumbente.makespan;
+    if (al_mejorar) al_mejorar(mejor, makespan, std::min(cota_inferior, makespan));
+    if (makespan <= cota_inferior) return mejor;
+
+    ReglasExpansion reglas = prep.reglas;
+    std::vector<SucesorCompacto> sucesores;
+    long long expansiones = 0;
+
+    for (int peso : BusquedaPonderada::PESOS) {
+        if (makespan <= cota_inferior) break;
+        reglas.f_limite = makespan;
+
+        ArenaNodos<NodoArena> arena;
+        TablaTransposicion vistos(opciones.memoria_cerrada);
+        std::priority_queue<BusquedaPonderada::Entrada, std::vector<BusquedaPonderada::Entrada>,
+                            std::greater<BusquedaPonderada::Entrada>> abierta;
+        auto prioridad = [&](int g, int f) {
+            return static_cast<long long>(BusquedaPonderada::PESO_BASE) * g + static_cast<long long>(peso) * (f - g);
+        };
+
+        int g_raiz = calcularCosteCompacto(inst, prep.raiz);
+        std::uint32_t indice_raiz = arena.reservar({prep.raiz, g_raiz, prep.f_inicial, SIN_PADRE, 0, 0, false});
+        vistos.insertar(prep.raiz.clave, static_cast<int>(indice_raiz), 0);
+        abierta.push({prioridad(g_raiz, prep.f_inicial), g_raiz, indice_raiz});
+
+        auto resultado = BusquedaPonderada::Resultado::Agotada;
+        std::uint32_t meta = SIN_PADRE;
+        while (!abierta.empty()) {
+            if ((++expansiones & 1023) == 0 && Reloj::now() >= limite) {
+                resultado = BusquedaPonderada::Resultado::SinTiempo;
+                break;
+            }
+            CONTAR(medida.datos.pico_abierta = std::max(medida.datos.pico_abierta, abierta.size()));
+            std::uint32_t indice = abierta.top().nodo;
+            abierta.pop();
+            NodoArena& actual = arena[indice];
+            if (actual.cerrado || actual.f_cost >= makespan) continue;
+            if (sinTareasPendientes(actual.estado)) {
+                resultado = BusquedaPonderada::Resultado::Meta;
+                meta = indice;
+                break;
+            }
+            actual.cerrado = true;
+
+            generarSucesoresCompactos(inst, actual.estado, actual.f_cost, reglas, sucesores);
+            CONTAR(++medida.datos.expandidos);
+            CONTAR(medida.datos.generados += static_cast<long long>(sucesores.size()));
+            for (const auto& sucesor : sucesores) {
+                auto mismo = [&](int v) { return arena[static_cast<std::uint32_t>(v)].estado == sucesor.estado; };
+                if (vistos.buscar(sucesor.estado.clave, mismo)) { // g solo depende del estado
+                    CONTAR(++medida.datos.duplicados);
+                    continue;
+                }
+                std::uint32_t hijo = arena.reservar({sucesor.estado, sucesor.g_cost, sucesor.f_cost, indice,
+                                                     static_cast<std::uint8_t>(sucesor.tarea),
+                                                     static_cast<std::uint8_t>(sucesor.maquina), false});
+                vistos.insertar(sucesor.estado.clave, static_cast<int>(hijo), tareasAsignadas(inst, sucesor.estado),
+                                mismo);
+                abierta.push({prioridad(sucesor.g_cost, sucesor.f_cost), sucesor.g_cost, hijo});
+            }
+        }
+
+        CONTAR(medida.datos.bytes = std::max(medida.datos.bytes, arena.bytes() + vistos.bytes() +
+                                             medida.datos.pico_abierta * sizeof(BusquedaPonderada::Entrada)));
+        if (resultado == BusquedaPonderada::Resultado::SinTiempo) break;
+        if (resultado == BusquedaPonderada::Resultado::Agotada) {
+            cota_inferior = makespan; // nada por debajo del incumbente: es óptimo
+            if (al_mejorar) al_mejorar(mejor, makespan, cota_inferior);
+            break;
+        }
+        // Nueva mejor solución, con garantía de estar a un factor w del óptimo.
+        makespan = arena[meta].g_cost;
+        mejor = reconstruirEstado(estado_inicial, inst, arena, meta);
+        int cota_ponderada = (makespan * BusquedaPonderada::PESO_BASE + peso - 1) / peso;
+        cota_inferior = std::max(cota_inferior, cota_ponderada);
+        if (al_mejorar) al_mejorar(mejor, makespan, cota_inferior);
+    }
+    return mejor;
+}
+
+//--------------------------------
+// Grupo de hilos
+//--------------------------------
+/*
+  Grupo fijo de hilos para paralelismo por fases: 'ejecutar(tarea)' llama a
+  tarea(h) para cada h en [0, tamano()) y espera a que terminen todas. El
+  hilo que llama hace de h = 0, así que con un solo hilo no hay sincronización.
+ */
+struct GrupoHilos {
+    std::vector<std::thread> hilos;
+    std::mutex mutex;
+    std::condition_variable hay_tarea, terminado;
+    const std::function<void(int)>* tarea = nullptr;
+    long long ronda = 0;
+    int pendientes = 0;
+    bool salir = false;
+
+    explicit GrupoHilos(int n) {
+        for (int h = 1; h < n; ++h) hilos.emplace_back(&GrupoHilos::bucle, this, h);
+    }
+
+    ~GrupoHilos() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            salir = true;
+        }
+        hay_tarea.notify_all();
+        for (auto& hilo : hilos) hilo.join();
+    }
+
+    int tamano() const { return static_cast<int>(hilos.size()) + 1; }
+
+    void ejecutar(const std::function<void(int)>& t) {
+        if (hilos.empty()) {
+            t(0);
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tarea = &t;
+            pendientes = static_cast<int>(hilos.size());
+            ++ronda;
+        }
+        hay_tarea.notify_all();
+        t(0);
+        std::unique_lock<std::mutex> lock(mutex);
+        terminado.wait(lock, [&] { return pendientes == 0; });
+    }
+
+    void bucle(int h) {
+        long long vista = 0;
+        while (true) {
+            const std::function<void(int)>* t;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                hay_tarea.wait(lock, [&] { return salir || ronda != vista; });
+                if (salir) return;
+                vista = ronda;
+                t = tarea;
+            }
+            (*t)(h);
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--pendientes == 0) terminado.notify_one();
+        }
+    }
+};
+
+//--------------------------------
+// Algoritmo de Búsqueda: A* por lotes de frontera
+//--------------------------------
+/*
+  Variante de 'A_estrella' que paraleliza la expansión sin repartir la
+  búsqueda: en cada paso extrae hasta 'nodos_por_lote' (K) nodos de la lista
+  abierta, en orden de f, los expande y puntúa en paralelo (generación de
+  sucesores y cota de cada hijo) sobre búferes propios de cada hilo, y
+  después fusiona todos los hijos en la arena, la tabla y la cola en un solo
+  paso secuencial, con las mismas reglas de duplicados que 'A_estrella'.
+  Optimalidad: si al llenar el lote sale una meta, solo se acepta cuando es
+  el primer nodo del lote; si no, vuelve a la cola y el lote se cierra ahí,
+  porque los hijos de los nodos ya extraídos podrían tener f menor que ella.
+  Expandir nodos con f mayor que el mínimo no rompe la optimalidad: solo
+  puede hacer trabajo de más, y un nodo cerrado que mejora se reabre.
+ */
+Estado A_estrella_lotes(const Estado& estado_inicial, const OpcionesBusqueda& opciones, MemoriaBusqueda& memoria) {
+    MedicionBusqueda medida(opciones.estadisticas);
+    PreparacionBusqueda& prep = memoria.prep;
+    if (!prepararBusqueda(estado_inicial, opciones, prep)) return A_estrella_general(estado_inicial);
+    const Instancia& inst = prep.inst;
+    const ReglasExpansion& reglas = prep.reglas;
+    const Incumbente& incumbente = prep.incumbente;
+    if (incumbente.makespan <= prep.f_inicial) return estadoDesdeIncumbente(estado_inicial, inst, incumbente);
+
+    ArenaNodos<NodoArena>& arena = memoria.arena;
+    arena.vaciar();
+    TablaTransposicion& vistos = memoria.vistos;
+    vistos.vaciar(opciones.memoria_cerrada);
+    ColaCubetas& abierta = memoria.abierta;
+    abierta.vaciar(inst.carga_total);
+
+    std::uint32_t indice_raiz = arena.reservar({prep.raiz, calcularCosteCompacto(inst, prep.raiz), prep.f_inicial,
+                                                SIN_PADRE, 0, 0, false});
+    vistos.insertar(prep.raiz.clave, static_cast<int>(indice_raiz), 0);
+    abierta.insertar(prep.f_inicial, indice_raiz);
+
+    const std::size_t K = static_cast<std::size_t>(std::max(1, opciones.nodos_por_lote));
+    GrupoHilos grupo(hilosEfectivos(opciones));
+    const int G = grupo.tamano();
+    std::vector<std::uint32_t> lote;
+    lote.reserve(K);
+    // Búfer de cada hilo: los sucesores de sus nodos del lote y el nodo padre de
+    // cada uno. Cada hilo los hace crecer (primer contacto en su nodo NUMA) y
+    // cada búfer ocupa sus propias líneas de caché.
+    struct alignas(64) BuferHilo {
+        std::vector<SucesorCompacto> sucesores, hijos;
+        std::vector<std::uint32_t> padres;
+    };
+    std::vector<BuferHilo> buferes(G);
+
+    std::function<void(int)> expandir = [&](int h) {
+        BuferHilo& b = buferes[h];
+        b.hijos.clear();
+        b.padres.clear();
+        for (std::size_t k = h; k < lote.size(); k += G) {
+            const NodoArena& nodo = arena[lote[k]];
+            generarSucesoresCompactos(inst, nodo.estado, nodo.f_cost, reglas, b.sucesores);
+            b.hijos.insert(b.hijos.end(), b.sucesores.begin(), b.sucesores.end());
+            b.padres.insert(b.padres.end(), b.sucesores.size(), lote[k]);
+        }
+    };
+    // Memoria: la compartida (arena, tabla, cola) más el desglose de los búferes por hilo.
+    [[maybe_unused]] auto anotarMemoria = [&] {
+        medida.datos.bytes = memoria.bytes();
+        medida.datos.memoria_hilos.clear();
+        for (const BuferHilo& b : buferes) {
+            MemoriaHilo m;
+            m.bufer = (b.sucesores.capacity() + b.hijos.capacity()) * sizeof(SucesorCompacto) +
+                      b.padres.capacity() * sizeof(std::uint32_t);
+            medida.datos.memoria_hilos.push_back(m);
+            medida.datos.bytes += m.bufer;
+        }
+    };
+
+    bool cancelada = false;
+    while (!abierta.vacia()) {
+        CONTAR(medida.datos.pico_abierta = std::max(medida.datos.pico_abierta, abierta.tamano));
+        if (carreraDetenida(opciones)) {
+            cancelada = true;
+            break;
+        }
+        // 1. Lote: hasta K nodos válidos en orden de f.
+        lote.clear();
+        while (lote.size() < K && !abierta.vacia()) {
+            int f_cubeta;
+            std::uint32_t indice = abierta.extraer(f_cubeta);
+            NodoArena& actual = arena[indice];
+            if (actual.cerrado || actual.f_cost != f_cubeta) continue;
+            if (lote.empty()) anunciarCotaInferior(opciones, f_cubeta); // menor f de la lista abierta
+            if (sinTareasPendientes(actual.estado)) {
+                if (lote.empty()) {
+                    anunciarCotaSuperior(opciones, actual.g_cost);
+                    CONTAR(anotarMemoria());
+                    return reconstruirEstado(estado_inicial, inst, arena, indice);
+                }
+                abierta.insertar(f_cubeta, indice); // se decide tras expandir el lote
+                break;
+            }
+            actual.cerrado = true;
+            lote.push_back(indice);
+        }
+
+        // 2. Expansión y puntuación en paralelo.
+        grupo.ejecutar(expandir);
+        CONTAR(medida.datos.expandidos += static_cast<long long>(lote.size()));
+
+        // 3. Fusión secuencial, hilo a hilo.
+        for (int h = 0; h < G; ++h) {
+            const BuferHilo& b = buferes[h];
+            CONTAR(medida.datos.generados += static_cast<long long>(b.hijos.size()));
+            for (std::size_t s = 0; s < b.hijos.size(); ++s) {
+                const SucesorCompacto& sucesor = b.hijos[s];
+                NodoArena hijo{sucesor.estado, sucesor.g_cost, sucesor.f_cost, b.padres[s],
+                               static_cast<std::uint8_t>(sucesor.tarea),
+                               static_cast<std::uint8_t>(sucesor.maquina), false};
+                auto mismo = [&](int v) { return arena[static_cast<std::uint32_t>(v)].estado == sucesor.estado; };
+                auto* visto = vistos.buscar(sucesor.estado.clave, mismo);
+                if (visto) {
+                    NodoArena& existente = arena[static_cast<std::uint32_t>(visto->valor)];
+                    CONTAR(++medida.datos.duplicados);
+                    if (existente.g_cost <= sucesor.g_cost) continue;
+                    CONTAR(medida.datos.reaperturas += existente.cerrado);
+                    existente = hijo;
+                    abierta.insertar(sucesor.f_cost, static_cast<std::uint32_t>(visto->valor));
+                    continue;
+                }
+                std::uint32_t indice_hijo = arena.reservar(hijo);
+                vistos.insertar(sucesor.estado.clave, static_cast<int>(indice_hijo),
+                                tareasAsignadas(inst, sucesor.estado), mismo);
+                abierta.insertar(sucesor.f_cost, indice_hijo);
+            }
+        }
+    }
+    CONTAR(anotarMemoria());
+    if (!cancelada) anunciarCotaInferior(opciones, reglas.f_limite);
+    if (opciones.cota_superior) return estadoDesdeIncumbente(estado_inicial, inst, incumbente);
+    return estado_inicial; // (no se encontró solución)
+}
+
+Estado A_estrella_lotes(const Estado& estado_inicial, const OpcionesBusqueda& opciones = OpcionesBusqueda{}) {
+    MemoriaBusqueda memoria;
+    return A_estrella_lotes(estado_inicial, opciones, memoria);
+}
+
+//--------------------------------
+// Núcleos vectoriales para las cargas
+//--------------------------------
+/*
+  Puntuación de los M hijos de un estado de 'busquedaHaz' en una sola pasada
+  sobre sus cargas ordenadas L[0] >= ... >= L[M-1]. El hijo j suma p a L[j]:
+    g_j = max(L[0], L[j] + p)
+    f_j = max(g_j, media, f_padre, cmin + p_sig, cmin + p_M + p_{M+1})
+  con cmin = L[M-1] salvo para j = M-1, donde es min(L[M-2], L[M-1] + p).
+  Un hijo con L[j] == L[j-1] repite el estado del anterior (simetría) y
+  recibe f = INT_MAX. La clave es la del padre más mezclar64(L[j] + p) menos
+  mezclar64(L[j]).
+  Como los hijos de un padre solo difieren en j, los M valores de g, f y
+  clave se calculan carril a carril y se escriben como tres vectores
+  separados (estructura de arrays), que es como los lee la selección.
+  Con AVX2 (compilando con -mavx2 o -march=native) se procesan 8 hijos por
+  iteración, y mezclar64 con 4 carriles de 64 bits; sin AVX2, el mismo
+  cálculo en escalar. La plantilla se especializa en M (M > 0, con los
+  bucles de longitud constante) o lo recibe en tiempo de ejecución (M = 0);
+  'elegirPuntuacionHaz' elige la versión con 'despacharMaquinas'.
+  La forma canónica de cada hijo no se ordena con una red de ordenación: con
+  el padre ya ordenado basta desplazar una carga ('sumarCargaCanonica'), y
+  eso solo se hace para los K hijos elegidos.
+ */
+struct CapaHaz {
+    int p;     // duración de la tarea que se asigna en esta capa
+    int p_sig; // duración de la siguiente
+    int p_m;   // duraciones M y M+1 posiciones más adelante (0 si no hay)
+    int p_m1;
+    int media; // ceil(carga total / M)
+};
+
+#if defined(__AVX2__)
+// Producto de enteros de 64 bits carril a carril (AVX2 solo multiplica 32 x 32 -> 64).
+inline __m256i multiplicar64(__m256i a, __m256i b) {
+    __m256i bajo = _mm256_mul_epu32(a, b);
+    __m256i cruzado = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(a, 32), b),
+                                       _mm256_mul_epu32(a, _mm256_srli_epi64(b, 32)));
+    return _mm256_add_epi64(bajo, _mm256_slli_epi64(cruzado, 32));
+}
+
+// 'mezclar64' en 4 carriles.
+inline __m256i mezclar64x4(__m256i x) {
+    x = _mm256_add_epi64(x, _mm256_set1_epi64x(static_cast<long long>(0x9E3779B97F4A7C15ull)));
+    x = multiplicar64(_mm256_xor_si256(x, _mm256_srli_epi64(x, 30)),
+                      _mm256_set1_epi64x(static_cast<long long>(0xBF58476D1CE4E5B9ull)));
+    x = multiplicar64(_mm256_xor_si256(x, _mm256_srli_epi64(x, 27)),
+                      _mm256_set1_epi64x(static_cast<long long>(0x94D049BB133111EBull)));
+    return _mm256_xor_si256(x, _mm256_srli_epi64(x, 31));
+}
+#endif
+
+template <int MF>
+void puntuarHijosHaz(const int* L, int m, const CapaHaz& capa, int f_padre, std::uint64_t clave_padre,
+                     int* f, int* g, std::uint64_t* clave) {
+    const int M = MF > 0 ? MF : m;
+    constexpr int INFINITO = std::numeric_limits<int>::max();
+    const int base = std::max(capa.media, f_padre);
+    const int cmin = L[M - 1];
+    // Parte de f común a todos los hijos menos el último.
+    const int f_comun = std::max({base, cmin + capa.p_sig, capa.p_m1 > 0 ? cmin + capa.p_m + capa.p_m1 : 0});
+
+    int j = 0;
+#if defined(__AVX2__)
+    const __m256i vp = _mm256_set1_epi32(capa.p), vL0 = _mm256_set1_epi32(L[0]);
+    const __m256i vcomun = _mm256_set1_epi32(f_comun), vinf = _mm256_set1_epi32(INFINITO);
+    const __m256i vclave = _mm256_set1_epi64x(static_cast<long long>(clave_padre));
+    for (; j + 8 <= M; j += 8) {
+        __m256i lj = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(L + j));
+        __m256i previa, iguales;
+        if (j > 0) {
+            previa = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(L + j - 1));
+            iguales = _mm256_cmpeq_epi32(lj, previa);
+        } else { // el hijo 0 no tiene anterior
+            previa = _mm256_permutevar8x32_epi32(lj, _mm256_set_epi32(6, 5, 4, 3, 2, 1, 0, 0));
+            iguales = _mm256_and_si256(_mm256_cmpeq_epi32(lj, previa), _mm256_set_epi32(-1, -1, -1, -1, -1, -1, -1, 0));
+        }
+        __m256i v = _mm256_add_epi32(lj, vp);
+        __m256i vg = _mm256_max_epi32(vL0, v);
+        __m256i vf = _mm256_blendv_epi8(_mm256_max_epi32(vg, vcomun), vinf, iguales);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(g + j), vg);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(f + j), vf);
+        for (int mitad = 0; mitad < 2; ++mitad) {
+            __m256i v64 = _mm256_cvtepu32_epi64(mitad ? _mm256_extracti128_si256(v, 1) : _mm256_castsi256_si128(v));
+            __m256i l64 = _mm256_cvtepu32_epi64(mitad ? _mm256_extracti128_si256(lj, 1) : _mm256_castsi256_si128(lj));
+            __m256i c = _mm256_sub_epi64(_mm256_add_epi64(vclave, mezclar64x4(v64)), mezclar64x4(l64));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(clave + j + 4 * mitad), c);
+        }
+    }
+#endif
+    for (; j < M; ++j) {
+        int v = L[j] + capa.p;
+        g[j] = std::max(L[0], v);
+        f[j] = (j > 0 && L[j] == L[j - 1]) ? INFINITO : std::max(g[j], f_comun);
+        clave[j] = clave_padre + mezclar64(v) - mezclar64(L[j]);
+    }
+    // Último hijo: su carga puede dejar de ser la mínima.
+    if (f[M - 1] != INFINITO) {
+        int v = L[M - 1] + capa.p;
+        int carga_min = M > 1 ? std::min(L[M - 2], v) : v;
+        f[M - 1] = std::max({g[M - 1], base, carga_min + capa.p_sig});
+        if (capa.p_m1 > 0) f[M - 1] = std::max(f[M - 1], carga_min + capa.p_m + capa.p_m1);
+    }
+}
+
+using PuntuacionHaz = void (*)(const int*, int, const CapaHaz&, int, std::uint64_t, int*, int*, std::uint64_t*);
+
+// Versión especializada para los números de máquinas habituales; para el resto, la genérica.
+inline PuntuacionHaz elegirPuntuacionHaz(int M) {
+    return despacharMaquinas(M, [](auto mf) -> PuntuacionHaz { return &puntuarHijosHaz<decltype(mf)::value>; });
+}
+
+//--------------------------------
+// Búsqueda en haz (beam search)
+//--------------------------------
+/*
+  Para instancias de cientos de tareas y decenas de máquinas, fuera del
+  alcance de los motores exactos y sin los límites de la codificación
+  compacta. Asigna las tareas en orden LPT, una capa por tarea, y en cada
+  capa conserva solo los 'anchura_haz' (K) mejores estados según f, la misma
+  cota que usa A* (L1 + par p_M + p_{M+1}); a igual f, menor g.
+  Los estados viven en dos búferes planos de K·M cargas (ordenadas de mayor a
+  menor) que se reservan una vez. Los hijos se puntúan sin construirlos: con
+  las cargas ordenadas, g, la cota y la clave del hijo salen en O(1) de las
+  del padre ('puntuarHijosHaz'); solo los K elegidos se materializan. El hijo
+  j del padre k es el candidato k·M + j, y sus f, g y clave se guardan en
+  tres vectores separados. La expansión de cada capa y la materialización
+  se reparten entre 'opciones.hilos' hilos.
+  Coste O(n·K·M) en tiempo; O(K·M) para los estados, más n·K registros de
+  (padre, máquina) para reconstruir la solución.
+ */
+// Lo que se guarda de cada estado elegido para reconstruir la solución.
+struct PasoHaz {
+    std::uint32_t padre;
+    std::uint32_t maquina;
+};
+
+Estado busquedaHaz(const Estado& estado_inicial, const OpcionesBusqueda& opciones = OpcionesBusqueda{}) {
+    const int M = static_cast<int>(estado_inicial.M.size());
+    const int n = static_cast<int>(estado_inicial.T.size());
+    if (M == 0 || n == 0) return estado_inicial;
+    if (modeloMaquinas(estado_inicial) != ModeloMaquinas::Identicas) {
+        // Las capas se deduplican por cargas ordenadas: sin máquinas idénticas, la constructiva.
+        InstanciaModelo im;
+        prepararModelo(estado_inicial, im);
+        return estadoDesdeIncumbente(estado_inicial, im.inst, planificarECT(im));
+    }
+    const int K = std::max(1, opciones.anchura_haz);
+    MedicionBusqueda medida(opciones.estadisticas);
+
+    // Tareas en orden LPT y máquinas en orden canónico, como en 'compactarEstado'.
+    std::vector<Tarea> tareas = estado_inicial.T;
+    std::stable_sort(tareas.begin(), tareas.end(), [](const Tarea& a, const Tarea& b) { return a.tiempo > b.tiempo; });
+    std::vector<Maquina> maquinas = estado_inicial.M;
+    std::stable_sort(maquinas.begin(), maquinas.end(), [](const Maquina& a, const Maquina& b) {
+        return a.tiempo_ocupado > b.tiempo_ocupado;
+    });
+    long long total = 0;
+    for (const auto& t : tareas) total += t.tiempo;
+    for (const auto& m : maquinas) total += m.tiempo_ocupado;
+    const int media = static_cast<int>((total + M - 1) / M);
+    auto tiempo = [&](int i) { return i < n ? tareas[i].tiempo : 0; };
+
+    std::vector<int> cargas(static_cast<std::size_t>(K) * M), siguientes(static_cast<std::size_t>(K) * M);
+    std::vector<std::uint64_t> claves(K), claves_sig(K);
+    std::vector<int> f_capa(K), f_capa_sig(K);
+    const std::size_t num_candidatos = static_cast<std::size_t>(K) * M;
+    std::vector<int> f_cand(num_candidatos), g_cand(num_candidatos);
+    std::vector<std::uint64_t> clave_cand(num_candidatos);
+    std::vector<std::uint32_t> elegidos;
+    elegidos.reserve(num_candidatos);
+    std::vector<std::uint64_t> vistos; // conjunto de claves de la capa (sondeo lineal)
+    std::size_t capacidad_vistos = 1;
+    while (capacidad_vistos < 4 * num_candidatos) capacidad_vistos *= 2;
+    std::vector<std::vector<PasoHaz>> historia(n); // (padre, máquina) de cada capa
+
+    for (int j = 0; j < M; ++j) {
+        cargas[j] = maquinas[j].tiempo_ocupado;
+        claves[0] += mezclar64(cargas[j]);
+    }
+    f_capa[0] = std::max(cargas[0], media);
+    int anchura = 1; // estados en la capa actual
+
+    GrupoHilos grupo(hilosEfectivos(opciones));
+    const int G = grupo.tamano();
+    const PuntuacionHaz puntuar = elegirPuntuacionHaz(M);
+
+    for (int d = 0; d < n; ++d) {
+        const int p = tiempo(d);
+        const CapaHaz capa{p, tiempo(d + 1), tiempo(d + M), tiempo(d + M + 1), media};
+
+        // 1. Expansión: cada padre escribe sus M candidatos en su tramo fijo.
+        std::function<void(int)> expandir = [&](int h) {
+            for (int k = h; k < anchura; k += G) {
+                std::size_t tramo = static_cast<std::size_t>(k) * M;
+                puntuar(&cargas[tramo], M, capa, f_capa[k], claves[k], &f_cand[tramo], &g_cand[tramo],
+                        &clave_cand[tramo]);
+            }
+        };
+        grupo.ejecutar(expandir);
+
+        // 2. Selección: candidatos válidos sin repetir estado y los K mejores.
+        elegidos.clear();
+        vistos.assign(capacidad_vistos, 0);
+        CONTAR(medida.datos.expandidos += anchura);
+        for (std::uint32_t c = 0; c < static_cast<std::uint32_t>(anchura) * M; ++c) {
+            if (f_cand[c] == std::numeric_limits<int>::max()) continue;
+            CONTAR(++medida.datos.generados);
+            std::uint64_t clave = TablaTransposicion::normalizar(clave_cand[c]);
+            std::size_t i = clave & (capacidad_vistos - 1);
+            while (vistos[i] != 0 && vistos[i] != clave) i = (i + 1) & (capacidad_vistos - 1);
+            if (vistos[i] == clave) {
+                CONTAR(++medida.datos.duplicados);
+                continue;
+            }
+            vistos[i] = clave;
+            elegidos.push_back(c);
+        }
+        auto mejor = [&](std::uint32_t a, std::uint32_t b) {
+            if (f_cand[a] != f_cand[b]) return f_cand[a] < f_cand[b];
+            if (g_cand[a] != g_cand[b]) return g_cand[a] < g_cand[b];
+            return a < b;
+        };
+        if (static_cast<int>(elegidos.size()) > K) {
+            std::nth_element(elegidos.begin(), elegidos.begin() + K, elegidos.end(), mejor);
+            elegidos.resize(K);
+        }
+        std::sort(elegidos.begin(), elegidos.end(), mejor);
+        CONTAR(medida.datos.pico_abierta = std::max(medida.datos.pico_abierta, elegidos.size()));
+
+        // 3. Materialización de los elegidos en el búfer siguiente.
+        historia[d].resize(elegidos.size());
+        std::function<void(int)> materializar = [&](int h) {
+            for (std::size_t e = h; e < elegidos.size(); e += G) {
+                std::uint32_t c = elegidos[e];
+                std::uint32_t padre = c / M, maquina = c % M;
+                int* destino = &siguientes[e * M];
+                std::copy_n(&cargas[static_cast<std::size_t>(padre) * M], M, destino);
+                sumarCargaCanonica(destino, static_cast<int>(maquina), p);
+                claves_sig[e] = clave_cand[c];
+                f_capa_sig[e] = f_cand[c];
+                historia[d][e] = {padre, maquina};
+            }
+        };
+        grupo.ejecutar(materializar);
+        anchura = static_cast<int>(elegidos.size());
+        cargas.swap(siguientes);
+        claves.swap(claves_sig);
+        f_capa.swap(f_capa_sig);
+    }
+
+#if ESTADISTICAS_BUSQUEDA
+    medida.datos.bytes = (cargas.capacity() + siguientes.capacity() + f_capa.capacity() + f_capa_sig.capacity() +
+                          f_cand.capacity() + g_cand.capacity()) * sizeof(int) +
+                         (claves.capacity() + claves_sig.capacity() + vistos.capacity() + clave_cand.capacity()) *
+                             sizeof(std::uint64_t) +
+                         elegidos.capacity() * sizeof(std::uint32_t);
+    for (const auto& capa : historia) medida.datos.bytes += capa.capacity() * sizeof(PasoHaz);
+#endif
+    // Reconstrucción: el mejor estado final es el primero (menor f = makespan).
+    std::vector<std::uint32_t> movimiento(n);
+    for (int d = n - 1, k = 0; d >= 0; --d) {
+        movimiento[d] = historia[d][k].maquina;
+        k = static_cast<int>(historia[d][k].padre);
+    }
+    std::vector<int> carga(M), maquina_en(M);
+    for (int j = 0; j < M; ++j) carga[j] = maquinas[j].tiempo_ocupado;
+    std::iota(maquina_en.begin(), maquina_en.end(), 0);
+    std::vector<int> maquina_de(n);
+    for (int d = 0; d < n; ++d) {
+        int pos = static_cast<int>(movimiento[d]);
+        maquina_de[d] = maquina_en[pos];
+        int destino = sumarCargaCanonica(carga.data(), pos, tareas[d].tiempo);
+        std::rotate(maquina_en.begin() + destino, maquina_en.begin() + pos, maquina_en.begin() + pos + 1);
+    }
+    Estado solucion = estado_inicial;
+    for (int d = 0; d < n; ++d) solucion = asignarTarea(solucion, tareas[d].id, maquinas[maquina_de[d]].id);
+    return solucion;
+}
+
+//--------------------------------
+// Programación dinámica: búsqueda binaria sobre el makespan
+//--------------------------------
+/*
+  Versión de decisión del problema: ¿caben todas las tareas con makespan C?
+  Es un bin packing con M máquinas de capacidad C - carga inicial. Con pocas
+  duraciones distintas, el conjunto de tareas pendientes se describe por
+  cuántas quedan de cada duración, y hay prod(n_t + 1) de esos vectores de
+  cuentas (n_t = tareas con la duración t), mucho menos que 2^n.
+  Las máquinas se llenan en un orden fijo. Para cada vector de cuentas S la
+  tabla guarda el mínimo lexicográfico de (máquinas cerradas k, carga w de la
+  máquina k) con que se pueden colocar las tareas de S. Es exacto: el estado
+  (k, w) domina a cualquier (k', w') con k < k' (puede cerrar máquinas hasta
+  llegar a k') o con k == k' y w <= w', y colocar una tarea conserva esa
+  dominancia. El coste por C es O(estados · duraciones distintas).
+  El óptimo se busca por bisección entre la cota inferior y la superior de
+  'prepararBusqueda'.
+ */
+constexpr std::size_t MAX_ESTADOS_PD = std::size_t{1} << 22; // 16 MiB de tabla
+constexpr long long LIMITE_PD_AUTOMATICO = 1 << 14;           // Σp · duraciones distintas
+constexpr std::size_t TRABAJO_PD_AUTOMATICO = std::size_t{1} << 20; // estados · duraciones distintas
+
+struct DecisionBinPacking {
+    static constexpr std::uint32_t INFACTIBLE = std::numeric_limits<std::uint32_t>::max();
+
+    const Instancia& inst;
+    const EstadoCompacto& raiz;
+    std::vector<int> duracion;                  // duraciones distintas, de mayor a menor
+    std::vector<int> cuenta;                    // tareas de cada duración
+    std::vector<std::size_t> peso;              // base del índice mixto de cada duración
+    std::vector<std::vector<int>> tareas_de;    // índices de tarea de cada duración
+    std::size_t num_estados = 1;
+    std::vector<std::uint32_t>& tabla;          // S -> (k << bits_carga) | w
+    std::vector<int> siguiente;                 // [t·(M+1) + k] = primera máquina >= k donde cabe t
+    std::vector<int> capacidad;
+    int C = 0;
+    int bits_carga = 0;
+
+    DecisionBinPacking(const Instancia& inst_, const EstadoCompacto& raiz_, std::vector<std::uint32_t>& tabla_)
+        : inst(inst_), raiz(raiz_), tabla(tabla_) {
+        std::vector<int> orden = tareasPorDuracion(inst);
+        for (int tarea : orden) {
+            if (duracion.empty() || duracion.back() != inst.tiempos[tarea]) {
+                duracion.push_back(inst.tiempos[tarea]);
+                cuenta.push_back(0);
+                tareas_de.emplace_back();
+            }
+            ++cuenta.back();
+            tareas_de.back().push_back(tarea);
+        }
+        for (int n_t : cuenta) {
+            peso.push_back(num_estados);
+            if (num_estados > MAX_ESTADOS_PD) continue; // ya no cabe; se evita el desbordamiento
+            num_estados *= static_cast<std::size_t>(n_t) + 1;
+        }
+    }
+
+    // Cabe en memoria y (k, w) cabe en 32 bits para cualquier C <= carga total.
+    bool cabe() const {
+        return num_estados <= MAX_ESTADOS_PD && inst.carga_total < (1 << 26);
+    }
+
+    // Coloca una tarea de duración t sobre el estado v: en la máquina abierta
+    // si cabe y, si no, en la primera de las siguientes con hueco para ella.
+    std::uint32_t colocar(std::uint32_t v, int t) const {
+        int k = static_cast<int>(v >> bits_carga);
+        int w = static_cast<int>(v & ((1u << bits_carga) - 1));
+        if (w + duracion[t] <= capacidad[k]) return v + duracion[t];
+        int destino = siguiente[t * (inst.num_maquinas + 1) + k + 1];
+        if (destino == inst.num_maquinas) return INFACTIBLE;
+        return (static_cast<std::uint32_t>(destino) << bits_carga) | static_cast<std::uint32_t>(duracion[t]);
+    }
+
+    // Rellena la tabla para el makespan C_ y dice si todas las tareas caben.
+    // Si la carrera se detiene a medias devuelve false sin haber decidido nada.
+    bool factible(int C_, const CarreraMotores* carrera = nullptr) {
+        const int M = inst.num_maquinas;
+        const int D = static_cast<int>(duracion.size());
+        C = C_;
+        bits_carga = 1;
+        while ((1 << bits_carga) <= C) ++bits_carga;
+        capacidad.assign(M, 0);
+        for (int j = 0; j < M; ++j) capacidad[j] = C - raiz.carga[j];
+        siguiente.assign(static_cast<std::size_t>(D) * (M + 1), M);
+        for (int t = 0; t < D; ++t)
+            for (int k = M - 1; k >= 0; --k)
+                siguiente[t * (M + 1) + k] = capacidad[k] >= duracion[t] ? k : siguiente[t * (M + 1) + k + 1];
+
+        tabla.resize(num_estados);
+        tabla[0] = 0; // ninguna tarea: máquina 0 abierta y vacía
+        std::vector<int> digito(D, 0);
+        for (std::size_t S = 1; S < num_estados; ++S) {
+            if ((S & 0xFFFF) == 0 && carrera && carrera->detenida()) return false;
+            int t = 0; // siguiente vector de cuentas en orden de índice
+            while (digito[t] == cuenta[t]) digito[t++] = 0;
+            ++digito[t];
+
+            std::uint32_t mejor = INFACTIBLE;
+            for (t = 0; t < D; ++t) {
+                if (digito[t] == 0) continue;
+                std::uint32_t previo = tabla[S - peso[t]];
+                if (previo != INFACTIBLE) mejor = std::min(mejor, colocar(previo, t));
+            }
+            tabla[S] = mejor;
+        }
+        return tabla[num_estados - 1] != INFACTIBLE;
+    }
+
+    // Tras un 'factible' con éxito: recorre la tabla desde el estado completo
+    // hasta el vacío y reparte las tareas en el orden encontrado.
+    Incumbente reconstruir() const {
+        std::vector<int> secuencia, digito = cuenta;
+        for (std::size_t S = num_estados - 1; S > 0;) {
+            for (int t = 0; t < static_cast<int>(duracion.size()); ++t) {
+                if (digito[t] == 0 || tabla[S - peso[t]] == INFACTIBLE) continue;
+                if (colocar(tabla[S - peso[t]], t) != tabla[S]) continue;
+                secuencia.push_back(t);
+                --digito[t];
+                S -= peso[t];
+                break;
+            }
+        }
+        Incumbente sol;
+        sol.maquina_de.assign(inst.num_tareas, 0);
+        std::vector<int> usadas(duracion.size(), 0);
+        std::vector<int> carga(raiz.carga.begin(), raiz.carga.begin() + inst.num_maquinas);
+        std::uint32_t v = 0;
+        for (auto it = secuencia.rbegin(); it != secuencia.rend(); ++it) {
+            v = colocar(v, *it);
+            int k = static_cast<int>(v >> bits_carga);
+            int tarea = tareas_de[*it][usadas[*it]++];
+            sol.maquina_de[tarea] = k;
+            carga[k] += inst.tiempos[tarea];
+        }
+        sol.makespan = *std::max_element(carga.begin(), carga.end());
+        return sol;
+    }
+};
+
+/*
+  Motor exacto para instancias con duraciones pequeñas y repetidas. Si la
+  tabla de cuentas no cabe en MAX_ESTADOS_PD se resuelve con 'A_estrella'.
+ */
+Estado resolverPorBinPacking(const Estado& estado_inicial, const OpcionesBusqueda& opciones,
+                             MemoriaBusqueda& memoria) {
+    PreparacionBusqueda& prep = memoria.prep;
+    if (!prepararBusqueda(estado_inicial, opciones, prep)) return A_estrella_general(estado_inicial);
+    if (prep.incumbente.makespan <= prep.f_inicial)
+        return estadoDesdeIncumbente(estado_inicial, prep.inst, prep.incumbente);
+
+    DecisionBinPacking decision(prep.inst, prep.raiz, memoria.tabla_pd);
+    if (!decision.cabe()) return A_estrella(estado_inicial, opciones, memoria);
+    MedicionBusqueda medida(opciones.estadisticas);
+
+    // Menor C factible en [cota inferior, cota superior - 1]. Sin cota
+    // superior se busca hasta la carga total, que siempre es factible.
+    // En una carrera el intervalo se recorta con la cota superior común y
+    // cada prueba publica una cota: superior si C es factible, inferior si no.
+    int lo = prep.f_inicial;
+    int hi = opciones.cota_superior ? prep.incumbente.makespan - 1 : prep.inst.carga_total;
+    int optimo = -1;
+    while (lo <= hi && !carreraDetenida(opciones)) {
+        if (opciones.carrera) hi = std::min(hi, opciones.carrera->cota_superior.load() - 1);
+        if (lo > hi) break;
+        int C = lo + (hi - lo) / 2;
+        // Cada prueba de C recorre la tabla entera: cada estado es una expansión.
+        CONTAR(medida.datos.expandidos += static_cast<long long>(decision.num_estados));
+        if (decision.factible(C, opciones.carrera)) {
+            optimo = C;
+            hi = C - 1;
+            anunciarCotaSuperior(opciones, C);
+        } else if (!carreraDetenida(opciones)) {
+            lo = C + 1;
+            anunciarCotaInferior(opciones, lo);
+        }
+    }
+    CONTAR(medida.datos.bytes = memoria.tabla_pd.capacity() * sizeof(std::uint32_t));
+    // Parada de la carrera con una solución mejor en otro motor: no compensa rehacer la tabla.
+    if (optimo >= 0 && carreraDetenida(opciones) && optimo > opciones.carrera->cota_superior.load()) optimo = -1;
+    if (optimo < 0 && prep.incumbente.maquina_de.empty()) return estado_inicial; // (parada sin solución)
+    if (optimo < 0) return estadoDesdeIncumbente(estado_inicial, prep.inst, prep.incumbente);
+    if (decision.C != optimo) decision.factible(optimo); // la tabla es la del último C probado
+    return estadoDesdeIncumbente(estado_inicial, prep.inst, decision.reconstruir());
+}
+
+Estado resolverPorBinPacking(const Estado& estado_inicial, const OpcionesBusqueda& opciones = OpcionesBusqueda{}) {
+    MemoriaBusqueda memoria;
+    return resolverPorBinPacking(estado_inicial, opciones, memoria);
+}
+
+//--------------------------------
+// Elección del motor
+//--------------------------------
+/*
+  Regla automática: la programación dinámica gana por órdenes de magnitud a
+  A* cuando las duraciones son enteros pequeños y se repiten, es decir,
+  cuando Σp · (duraciones distintas) es pequeño y cada prueba de C recorre
+  pocos estados (TRABAJO_PD_AUTOMATICO). En otro caso, A*. Fuera de la
+  codificación compacta A* pasaría a 'A_estrella_general', sin límite de
+  memoria, así que se usa la ramificación y poda, que no la necesita.
+ */
+Motor elegirMotor(const Estado& estado) {
+    if (modeloMaquinas(estado) != ModeloMaquinas::Identicas) return Motor::RamificacionYPoda;
+    if (estado.M.size() > MAX_MAQUINAS || estado.T.size() > MAX_TAREAS) return Motor::RamificacionYPoda;
+    std::map<int, int> cuenta;
+    long long suma = 0;
+    for (const auto& t : estado.T) {
+        ++cuenta[t.tiempo];
+        suma += t.tiempo;
+    }
+    if (suma * static_cast<long long>(cuenta.size()) > LIMITE_PD_AUTOMATICO) return Motor::AEstrella;
+    std::size_t estados = 1;
+    for (const auto& [tiempo, n_t] : cuenta) {
+        estados *= static_cast<std::size_t>(n_t) + 1;
+        if (estados * cuenta.size() > TRABAJO_PD_AUTOMATICO) return Motor::AEstrella;
+    }
+    return Motor::ProgramacionDinamica;
+}
+
+// Resuelve el estado con el motor de 'opciones.motor'. A*, A* por lotes y la
+// programación dinámica trabajan sobre 'memoria'; IDA*, HDA* y la
+// ramificación y poda usan la suya.
+Estado resolver(const Estado& estado_inicial, const OpcionesBusqueda& opciones, MemoriaBusqueda& memoria) {
+    Motor motor = opciones.motor == Motor::Automatico ? elegirMotor(estado_inicial) : opciones.motor;
+    switch (motor) {
+    case Motor::IDAEstrella: return IDA_estrella(estado_inicial, opciones);
+    case Motor::HDAEstrella: return HDA_estrella(estado_inicial, opciones);
+    case Motor::AEstrellaLotes: return A_estrella_lotes(estado_inicial, opciones, memoria);
+    case Motor::ProgramacionDinamica: return resolverPorBinPacking(estado_inicial, opciones, memoria);
+    case Motor::RamificacionYPoda: return ramificacionYPoda(estado_inicial, opciones);
+    default: return A_estrella(estado_inicial, opciones, memoria);
+    }
+}
+
+Estado resolver(const Estado& estado_inicial, const OpcionesBusqueda& opciones = OpcionesBusqueda{}) {
+    MemoriaBusqueda memoria;
+    return resolver(estado_inicial, opciones, memoria);
+}
+
+//--------------------------------
+// Cartera de motores
+//--------------------------------
+/*
+  Qué motor es más rápido depende mucho de la forma de la instancia y no se
+  sabe de antemano: A* gana en unas, la ramificación y poda o la programación
+  dinámica en otras. 'resolverCartera' lanza cada motor de 'motores' en su
+  propio hilo con 'resolver' (la interfaz común) sobre la misma instancia y
+  una 'CarreraMotores' común:
+  - cada solución encontrada baja la cota superior común, de la que también
+    podan la ramificación y poda y la programación dinámica;
+  - cada cota demostrada (el menor f de la lista abierta de A*, el umbral de
+    IDA*, una C infactible) sube la cota inferior común;
+  - cuando se encuentran, o cuando un motor termina (todos son exactos), se
+    pide parar a los demás, que devuelven lo mejor que tengan.
+  Se devuelve la mejor solución completa. Los motores paralelos (HDA*, A*
+  por lotes) usan cada uno 'opciones.hilos' hilos más.
+  Con 'opciones.estadisticas' se suman los contadores de todos los motores;
+  'segundos' es el tiempo de la carrera.
+  Sin máquinas idénticas, o fuera de los límites compactos, no hay carrera:
+  se resuelve solo con la ramificación y poda, como 'elegirMotor'.
+ */
+const std::vector<Motor> MOTORES_CARTERA = {Motor::AEstrella, Motor::RamificacionYPoda,
+                                            Motor::ProgramacionDinamica, Motor::IDAEstrella};
+
+Estado resolverCartera(const Estado& estado_inicial, const OpcionesBusqueda& opciones = OpcionesBusqueda{},
+                       const std::vector<Motor>& motores = MOTORES_CARTERA) {
+    // Sin máquinas idénticas solo la ramificación y poda tiene versión propia.
+    // Por encima de MAX_MAQUINAS o MAX_TAREAS, A* y la programación dinámica
+    // caen en el A* general, que no se puede parar: correría sin límite.
+    if (modeloMaquinas(estado_inicial) != ModeloMaquinas::Identicas || estado_inicial.M.size() > MAX_MAQUINAS ||
+        estado_inicial.T.size() > MAX_TAREAS)
+        return ramificacionYPoda(estado_inicial, opciones);
+    MedicionBusqueda medida(opciones.estadisticas);
+    CarreraMotores carrera;
+    std::vector<Estado> soluciones(motores.size());
+    std::vector<EstadisticasBusqueda> estadisticas(motores.size());
+    std::vector<std::thread> hilos;
+    for (std::size_t k = 0; k < motores.size(); ++k) {
+        hilos.emplace_back([&, k] {
+            OpcionesBusqueda propias = opciones;
+            propias.motor = motores[k];
+            propias.carrera = &carrera;
+            propias.estadisticas = opciones.estadisticas ? &estadisticas[k] : nullptr;
+            soluciones[k] = resolver(estado_inicial, propias);
+            carrera.detener();
+        });
+    }
+    for (auto& hilo : hilos) hilo.join();
+    for (const EstadisticasBusqueda& e : estadisticas) medida.datos.acumular(e);
+
+    const Estado* mejor = nullptr;
+    for (const Estado& solucion : soluciones) {
+        if (!solucion.T.empty()) continue; // motor parado sin solución completa
+        if (!mejor || calcularCoste(solucion) < calcularCoste(*mejor)) mejor = &solucion;
+    }
+    return mejor ? *mejor : estado_inicial;
+}
+
+//--------------------------------
+// Resolución incremental
+//--------------------------------
+/*
+  Para planificaciones que cambian poco entre resoluciones (llega una tarea,
+  se cancela otra, cambia una duración). 'ResolutorIncremental' guarda la
+  última solución y la repara con cada cambio en O(M) o O(n):
+  - anadirTarea: la tarea nueva va a la máquina menos cargada.
+  - eliminarTarea: se quita de su máquina.
+  - cambiarDuracion: se queda en su máquina con la nueva duración.
+  También guarda una cota inferior del óptimo: añadir una tarea o alargarla
+  no baja el óptimo, y quitar (o acortar) d unidades de trabajo lo baja como
+  mucho d, porque devolverlas a cualquier máquina da una solución completa.
+  'resolver' devuelve la solución reparada sin buscar si ya alcanza la cota
+  (por ejemplo, si la tarea nueva cabe en el hueco de una máquina). Si no,
+  lanza el motor de 'opciones' con la solución reparada como incumbente
+  ('OpcionesBusqueda::solucion_previa') y la cota guardada, sobre la misma
+  'MemoriaBusqueda', que ya tiene la arena y las tablas reservadas.
+  Los estados explorados en la resolución anterior no se reutilizan: tras
+  el cambio tienen otro conjunto de tareas pendientes y otras claves.
+ */
+struct ResolutorIncremental {
+    OpcionesBusqueda opciones;
+    MemoriaBusqueda memoria;
+    Estado problema;          // máquinas vacías y tareas actuales
+    Estado solucion;          // última solución, reparada con los cambios posteriores
+    int cota_inferior = 0;    // cota inferior válida del óptimo de 'problema'
+    bool optima = true;       // 'solucion' es óptima para 'problema'
+    int siguiente_id = 1;
+
+    // Con num_maquinas < 1 no hay dónde planificar: no admite tareas.
+    explicit ResolutorIncremental(int num_maquinas, const OpcionesBusqueda& opciones_ = OpcionesBusqueda{})
+        : opciones(opciones_) {
+        for (int i = 1; i <= num_maquinas; ++i) problema.M.push_back({i});
+        solucion = problema;
+    }
+
+    // Añade una tarea de duración 'tiempo' y devuelve su id (0 si no hay máquinas).
+    int anadirTarea(int tiempo) {
+        if (solucion.M.empty()) return 0;
+        int id = siguiente_id++;
+        problema.T.push_back({id, tiempo});
+        auto menor = std::min_element(solucion.M.begin(), solucion.M.end(), [](const Maquina& a, const Maquina& b) {
+            return a.tiempo_ocupado < b.tiempo_ocupado;
+        });
+        menor->tiempo_ocupado += tiempo;
+        solucion.Asignaciones.push_back({id, menor->id, 0});
+        optima = false;
+        return id;
+    }
+
+    // Quita la tarea 'id'. Devuelve false si no existe.
+    bool eliminarTarea(int id) {
+        return modificar(id, [&](Tarea& tarea, Maquina& maquina, std::size_t a) {
+            maquina.tiempo_ocupado -= tarea.tiempo;
+            solucion.Asignaciones.erase(solucion.Asignaciones.begin() + a);
+            cota_inferior = std::max(0, cota_inferior - tarea.tiempo);
+            problema.T.erase(problema.T.begin() + (&tarea - problema.T.data()));
+        });
+    }
+
+    // Cambia la duración de la tarea 'id'. Devuelve false si no existe.
+    bool cambiarDuracion(int id, int tiempo) {
+        return modificar(id, [&](Tarea& tarea, Maquina& maquina, std::size_t) {
+            maquina.tiempo_ocupado += tiempo - tarea.tiempo;
+            if (tiempo < tarea.tiempo) cota_inferior = std::max(0, cota_inferior - (tarea.tiempo - tiempo));
+            tarea.tiempo = tiempo;
+        });
+    }
+
+    int makespan() const { return calcularCoste(solucion); }
+
+    // Solución óptima del problema actual.
+    const Estado& resolver() {
+        if (optima || problema.M.empty()) return solucion;
+        // Cotas O(n) de 'calcularCotaInferior' en la raíz: media, p_max y p_M + p_{M+1}.
+        const int M = static_cast<int>(problema.M.size());
+        std::vector<int> tiempos;
+        long long total = 0;
+        for (const Tarea& t : problema.T) {
+            tiempos.push_back(t.tiempo);
+            total += t.tiempo;
+        }
+        cota_inferior = std::max(cota_inferior, static_cast<int>((total + M - 1) / M));
+        if (static_cast<int>(tiempos.size()) > M) {
+            std::nth_element(tiempos.begin(), tiempos.begin() + M, tiempos.end(), std::greater<int>());
+            int p_m1 = tiempos[M];
+            int p_m = *std::min_element(tiempos.begin(), tiempos.begin() + M);
+            cota_inferior = std::max(cota_inferior, p_m + p_m1);
+        }
+        if (!tiempos.empty()) cota_inferior = std::max(cota_inferior, *std::max_element(tiempos.begin(), tiempos.end()));
+        if (makespan() > cota_inferior) {
+            OpcionesBusqueda opciones_busqueda = opciones;
+            opciones_busqueda.solucion_previa = &solucion;
+            opciones_busqueda.cota_inferior_previa = cota_inferior;
+            Estado nueva = ::resolver(problema, opciones_busqueda, memoria);
+            solucion = std::move(nueva);
+        }
+        cota_inferior = makespan();
+        optima = true;
+        return solucion;
+    }
+
+private:
+    // Llama a 'cambio' con la tarea 'id', la máquina que la tiene en 'solucion' y
+    // el índice de su asignación.
+    template <typename F>
+    bool modificar(int id, F&& cambio) {
+        auto tarea = std::find_if(problema.T.begin(), problema.T.end(), [&](const Tarea& t) { return t.id == id; });
+        auto asignacion = std::find_if(solucion.Asignaciones.begin(), solucion.Asignaciones.end(),
+                                       [&](const Asignacion& a) { return a.tarea_id == id; });
+        if (tarea == problema.T.end() || asignacion == solucion.Asignaciones.end()) return false;
+        auto maquina = std::find_if(solucion.M.begin(), solucion.M.end(),
+                                    [&](const Maquina& m) { return m.id == asignacion->maquina_id; });
+        cambio(*tarea, *maquina, static_cast<std::size_t>(asignacion - solucion.Asignaciones.begin()));
+        optima = false;
+        return true;
+    }
+};
+
+//--------------------------------
+// Búsqueda de grandes vecindarios (LNS)
+//--------------------------------
+/*
+  Para instancias muy lejos del alcance de los motores exactos. Se parte de
+  la planificación ECT (LPT con máquinas idénticas) y, hasta agotar el plazo
+  o alcanzar la cota inferior, se repiten rondas:
+  1. Descenso rápido sobre la máquina más cargada: mover una de sus tareas a
+     otra máquina o intercambiarla con una de otra máquina. Con las cargas de
+     cada máquina al día, cada movimiento se evalúa en O(1).
+  2. Un vecindario por hilo: se liberan 'opciones.maquinas_vecindario'
+     máquinas distintas (las del hilo 0 incluyen la más cargada y la menos
+     cargada) y, de sus tareas, hasta 'opciones.tareas_vecindario' al azar;
+     el resto sigue en su máquina como carga inicial. Ese subproblema se
+     resuelve con 'resolver' y el motor de 'opciones.motor', con una
+     'CarreraMotores' propia cuya cota superior es la mayor carga actual de
+     sus máquinas (solo sirven soluciones mejores) y cuyo plazo es de
+     'opciones.plazo_vecindario' segundos.
+  3. Los vecindarios no comparten máquinas, así que se aplican todas las
+     mejoras de la ronda. Ninguna empeora el makespan: solo bajan la mayor
+     carga de sus máquinas.
+  Cada mejora del makespan se entrega a 'al_mejorar' con la cota inferior de
+  'cotaInferiorModelo'. Vale para los tres modelos de máquinas.
+ */
+
+// Planificación completa con la carga y las tareas de cada máquina al día.
+struct PlanVecindarios {
+    const InstanciaModelo& im;
+    std::vector<int> maquina_de;             // posición de máquina de cada tarea
+    std::vector<int> carga;                  // carga por posición de máquina
+    std::vector<std::vector<int>> tareas_de; // tareas de cada máquina, sin orden
+    std::vector<int> posicion;               // índice de cada tarea en su 'tareas_de'
+
+    PlanVecindarios(const InstanciaModelo& im_, const Incumbente& sol)
+        : im(im_), maquina_de(sol.maquina_de), carga(im_.carga), tareas_de(im_.inst.num_maquinas),
+          posicion(im_.inst.num_tareas) {
+        for (int t = 0; t < im.inst.num_tareas; ++t) {
+            int j = maquina_de[t];
+            carga[j] += duracion(t, j);
+            posicion[t] = static_cast<int>(tareas_de[j].size());
+            tareas_de[j].push_back(t);
+        }
+    }
+
+    int duracion(int t, int j) const { return duracionModelo(im, t, j); }
+    int masCargada() const {
+        return static_cast<int>(std::max_element(carga.begin(), carga.end()) - carga.begin());
+    }
+    int makespan() const { return carga[masCargada()]; }
+
+    // Pasa la tarea t a la máquina j.
+    void mover(int t, int j) {
+        int i = maquina_de[t];
+        if (i == j) return;
+        carga[i] -= duracion(t, i);
+        carga[j] += duracion(t, j);
+        int ultima = tareas_de[i].back();
+        tareas_de[i][posicion[t]] = ultima;
+        posicion[ultima] = posicion[t];
+        tareas_de[i].pop_back();
+        posicion[t] = static_cast<int>(tareas_de[j].size());
+        tareas_de[j].push_back(t);
+        maquina_de[t] = j;
+    }
+
+    /*
+      Paso 1: mientras se pueda, mueve una tarea de la máquina más cargada a
+      otra, o la intercambia con una tarea de otra máquina, si las dos cargas
+      resultantes quedan por debajo de la mayor. Cada cambio baja
+      lexicográficamente el vector de cargas ordenado, así que termina;
+      también para al llegar a 'limite'.
+     */
+    void descender(CarreraMotores::Reloj::time_point limite) {
+        const int M = im.inst.num_maquinas;
+        for (bool mejora = true; mejora;) {
+            mejora = false;
+            const int a = masCargada();
+            const int mayor = carga[a];
+            for (std::size_t k = 0; k < tareas_de[a].size() && !mejora; ++k) {
+                if ((k & 63) == 63 && CarreraMotores::Reloj::now() >= limite) return;
+                const int t = tareas_de[a][k];
+                const int sin_t = mayor - duracion(t, a);
+                for (int b = 0; b < M && !mejora; ++b) {
+                    if (b == a) continue;
+                    const int con_t = carga[b] + duracion(t, b);
+                    if (std::max(sin_t, con_t) < mayor) { // mover t de a a b
+                        mover(t, b);
+                        mejora = true;
+                        break;
+                    }
+                    for (int u : tareas_de[b]) { // intercambiar t y u
+                        if (std::max(sin_t + duracion(u, a), con_t - duracion(u, b)) < mayor) {
+                            mover(t, b);
+                            mover(u, a);
+                            mejora = true;
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+    }
+};
+
+// Vecindario de un hilo en una ronda: máquinas y tareas liberadas y, si el
+// subproblema ha mejorado, la nueva máquina de cada tarea liberada.
+struct Vecindario {
+    std::vector<int> maquinas;
+    std::vector<int> tareas;
+    std::vector<int> nueva_maquina;
+    bool mejora = false;
+    bool agotado = false; // el motor terminó antes del plazo: el resultado es óptimo
+    EstadisticasBusqueda estadisticas;
+};
+
+/*
+  Paso 2 para un vecindario: las tareas liberadas sobre sus máquinas, con
+  la carga de las demás tareas fija. En el subproblema las tareas y las
+  máquinas se identifican por su índice en el vecindario.
+ */
+void resolverVecindario(const Estado& estado_inicial, const PlanVecindarios& plan, const OpcionesBusqueda& opciones,
+                        CarreraMotores::Reloj::time_point plazo, MemoriaBusqueda& memoria, Vecindario& v) {
+    const int k = static_cast<int>(v.maquinas.size());
+    const int m = static_cast<int>(v.tareas.size());
+    v.mejora = v.agotado = false;
+    v.estadisticas = EstadisticasBusqueda{};
+
+    Estado sub;
+    int limite = 0;
+    for (int c = 0; c < k; ++c) {
+        const int j = v.maquinas[c];
+        sub.M.push_back({c, plan.carga[j], estado_inicial.M[j].velocidad});
+        limite = std::max(limite, plan.carga[j]);
+    }
+    for (int i = 0; i < m; ++i) {
+        const int t = v.tareas[i];
+        const int c = static_cast<int>(std::find(v.maquinas.begin(), v.maquinas.end(), plan.maquina_de[t]) -
+                                       v.maquinas.begin());
+        sub.M[c].tiempo_ocupado -= plan.duracion(t, plan.maquina_de[t]);
+        sub.T.push_back({i, estado_inicial.T[t].tiempo});
+    }
+    if (plan.im.modelo == ModeloMaquinas::NoRelacionadas) {
+        auto tiempos = std::make_shared<MatrizTiempos>(m, k);
+        for (int i = 0; i < m; ++i)
+            for (int c = 0; c < k; ++c) tiempos->fila(i)[c] = plan.duracion(v.tareas[i], v.maquinas[c]);
+        sub.tiempos = std::move(tiempos);
+    }
+
+    CarreraMotores carrera;
+    carrera.cota_superior = limite;
+    carrera.plazo = plazo;
+    OpcionesBusqueda propias = opciones;
+    propias.hilos = 1;
+    propias.directorio_externo = nullptr;
+    propias.solucion_previa = nullptr;
+    propias.cota_inferior_previa = 0;
+    propias.carrera = &carrera;
+    propias.estadisticas = opciones.estadisticas ? &v.estadisticas : nullptr;
+    Estado solucion = resolver(sub, propias, memoria);
+    v.agotado = CarreraMotores::Reloj::now() < plazo;
+    if (!solucion.T.empty() || calcularCoste(solucion) >= limite) return;
+    v.nueva_maquina.assign(m, 0);
+    for (const Asignacion& a : solucion.Asignaciones) v.nueva_maquina[a.tarea_id] = v.maquinas[a.maquina_id];
+    v.mejora = true;
+}
+
+// 'Estado' del plan en O(n + M); 'estadoDesdeIncumbente' copia el estado en cada tarea.
+Estado estadoDesdePlan(const Estado& estado_inicial, const PlanVecindarios& plan) {
+    MEDIR_FASE(Fase::Reconstruccion);
+    Estado solucion = estado_inicial;
+    solucion.T.clear();
+    for (std::size_t t = 0; t < estado_inicial.T.size(); ++t)
+        solucion.Asignaciones.push_back({estado_inicial.T[t].id, estado_inicial.M[plan.maquina_de[t]].id, 0});
+    for (std::size_t j = 0; j < solucion.M.size(); ++j) solucion.M[j].tiempo_ocupado = plan.carga[j];
+    return solucion;
+}
+
+/*
+  Motor LNS. 'presupuesto_s' es el plazo total en segundos desde la llamada;
+  al vencer se devuelve el mejor plan. Usa 'opciones.hilos' hilos.
+ */
+Estado busquedaVecindarios(const Estado& estado_inicial, double presupuesto_s,
+                           const CallbackMejora& al_mejorar = nullptr,
+                           const OpcionesBusqueda& opciones = OpcionesBusqueda{}) {
+    using Reloj = CarreraMotores::Reloj;
+    auto segundos = [](double s) {
+        return std::chrono::duration_cast<Reloj::duration>(std::chrono::duration<double>(s));
+    };
+    const auto fin = Reloj::now() + segundos(presupuesto_s);
+    const int M = static_cast<int>(estado_inicial.M.size());
+    if (M == 0) return estado_inicial;
+    MedicionBusqueda medida(opciones.estadisticas);
+
+    InstanciaModelo im;
+    prepararModelo(estado_inicial, im);
+    const int n = im.inst.num_tareas;
+    const int cota = cotaInferiorModelo(im);
+    PlanVecindarios plan(im, planificarECT(im));
+    int makespan = plan.makespan();
+    auto anunciar = [&] {
+        if (al_mejorar) al_mejorar(estadoDesdePlan(estado_inicial, plan), makespan, std::min(cota, makespan));
+    };
+    anunciar();
+
+    const int k = std::max(1, std::min({opciones.maquinas_vecindario, M, MAX_MAQUINAS}));
+    const int max_tareas = std::max(1, std::min(opciones.tareas_vecindario, MAX_TAREAS));
+    const int H = std::max(1, std::min(hilosEfectivos(opciones), M / k));
+    GrupoHilos grupo(H);
+    std::vector<MemoriaBusqueda> memorias(H);
+    std::vector<Vecindario> vecindarios(H);
+    std::vector<int> maquinas(M);
+    std::iota(maquinas.begin(), maquinas.end(), 0);
+    std::uint64_t semilla = 0;
+    auto azar = [&](int tope) { return static_cast<int>(mezclar64(++semilla) % static_cast<std::uint64_t>(tope)); };
+    auto alFrente = [&](int j, int pos) { std::swap(maquinas[pos], *std::find(maquinas.begin(), maquinas.end(), j)); };
+    Reloj::time_point plazo;
+    const std::function<void(int)> trabajo = [&](int h) {
+        resolverVecindario(estado_inicial, plan, opciones, plazo, memorias[h], vecindarios[h]);
+    };
+
+    bool cambios = true;
+    while (makespan > cota && Reloj::now() < fin) {
+        if (cambios) plan.descender(fin);
+        if (plan.makespan() < makespan) {
+            makespan = plan.makespan();
+            anunciar();
+            if (makespan <= cota) break;
+        }
+
+        for (int i = M - 1; i > 0; --i) std::swap(maquinas[i], maquinas[azar(i + 1)]);
+        const int mayor = plan.masCargada();
+        const int menor = static_cast<int>(std::min_element(plan.carga.begin(), plan.carga.end()) - plan.carga.begin());
+        alFrente(mayor, 0);
+        if (k > 1 && menor != mayor) alFrente(menor, 1);
+        for (int h = 0; h < H; ++h) {
+            Vecindario& v = vecindarios[h];
+            v.maquinas.assign(maquinas.begin() + h * k, maquinas.begin() + (h + 1) * k);
+            v.tareas.clear();
+            for (int j : v.maquinas) v.tareas.insert(v.tareas.end(), plan.tareas_de[j].begin(), plan.tareas_de[j].end());
+            const int total = static_cast<int>(v.tareas.size());
+            for (int i = 0; i < max_tareas && i < total; ++i) std::swap(v.tareas[i], v.tareas[i + azar(total - i)]);
+            if (total > max_tareas) v.tareas.resize(max_tareas);
+        }
+        plazo = std::min(fin, Reloj::now() + segundos(opciones.plazo_vecindario));
+        grupo.ejecutar(trabajo);
+
+        cambios = false;
+        bool completo = false; // un vecindario era la instancia entera y se resolvió hasta el final
+        for (Vecindario& v : vecindarios) {
+            medida.datos.acumular(v.estadisticas);
+            if (v.mejora) {
+                for (std::size_t i = 0; i < v.tareas.size(); ++i) plan.mover(v.tareas[i], v.nueva_maquina[i]);
+                cambios = true;
+            }
+            completo = completo || (v.agotado && static_cast<int>(v.maquinas.size()) == M &&
+                                    static_cast<int>(v.tareas.size()) == n);
+        }
+        if (plan.makespan() < makespan) {
+            makespan = plan.makespan();
+            anunciar();
+        }
+        if (completo) break;
+    }
+
+    std::size_t bytes = 0;
+    for (const MemoriaBusqueda& memoria : memorias) bytes += memoria.bytes();
+    CONTAR(medida.datos.bytes = bytes + im.tiempos.lineas.capacity() * sizeof(MatrizTiempos::LineaCache) +
+                                static_cast<std::size_t>(n) * 3 * sizeof(int));
+    return estadoDesdePlan(estado_inicial, plan);
+}
+
+//--------------------------------
+// Resolución por lotes
+//--------------------------------
+/*
+  Para resolver muchas instancias independientes (un turno, una célula de
+  trabajo...) de una vez. Las instancias se reparten en tramos contiguos,
+  uno por hilo de un 'GrupoHilos'; cada hilo resuelve su tramo desde el
+  principio y, al acabarlo, roba instancias del final de los tramos de los
+  demás. Cada hilo tiene su 'MemoriaBusqueda', que se reutiliza de una
+  instancia a la siguiente.
+  Los resultados se devuelven en el orden de entrada. Cada instancia se
+  resuelve con un solo hilo; 'opciones.hilos' es el número de hilos del lote.
+ */
+struct InstanciaLote {
+    int num_maquinas = 0;
+    std::vector<int> tiempos;
+};
+
+struct ResultadoLote {
+    Estado solucion;
+    int makespan = 0;
+    double segundos = 0; // tiempo de resolución de esta instancia
+    EstadisticasBusqueda estadisticas;
+};
+
+// Estado inicial de una instancia: máquinas 1..N vacías y tareas 1..n, como en 'main'.
+Estado estadoDesdeTiempos(int num_maquinas, const std::vector<int>& tiempos) {
+    Estado estado;
+    for (int i = 1; i <= num_maquinas; ++i) estado.M.push_back({i});
+    for (int i = 0; i < static_cast<int>(tiempos.size()); ++i) estado.T.push_back({i + 1, tiempos[i]});
+    return estado;
+}
+
+// Tramo [cabeza, cola) de índices de instancias de un hilo. El dueño toma
+// por la cabeza y los demás roban por la cola.
+struct TramoLote {
+    std::mutex mutex;
+    int cabeza = 0;
+    int cola = 0;
+
+    bool tomar(int& i) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (cabeza == cola) return false;
+        i = cabeza++;
+        return true;
+    }
+
+    bool robar(int& i) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (cabeza == cola) return false;
+        i = --cola;
+        return true;
+    }
+};
+
+std::vector<ResultadoLote> resolverLote(const std::vector<InstanciaLote>& lote,
+                                        const OpcionesBusqueda& opciones = OpcionesBusqueda{}) {
+    const int n = static_cast<int>(lote.size());
+    std::vector<ResultadoLote> resultados(n);
+    if (n == 0) return resultados;
+    const int G = std::min(hilosEfectivos(opciones), n);
+
+    std::vector<TramoLote> tramos(G);
+    for (int h = 0; h < G; ++h) {
+        tramos[h].cabeza = static_cast<int>(static_cast<long long>(n) * h / G);
+        tramos[h].cola = static_cast<int>(static_cast<long long>(n) * (h + 1) / G);
+    }
+    GrupoHilos grupo(G);
+    std::function<void(int)> trabajar = [&](int h) {
+        OpcionesBusqueda por_instancia = opciones;
+        por_instancia.hilos = 1;
+        MemoriaBusqueda memoria;
+        while (true) {
+            int i;
+            bool hay = tramos[h].tomar(i);
+            for (int v = 1; !hay && v < G; ++v) hay = tramos[(h + v) % G].robar(i);
+            if (!hay) return; // todos los tramos vacíos: no se añaden instancias nuevas
+
+            auto inicio = std::chrono::steady_clock::now();
+            Estado estado = estadoDesdeTiempos(lote[i].num_maquinas, lote[i].tiempos);
+            por_instancia.estadisticas = &resultados[i].estadisticas;
+            resultados[i].solucion = resolver(estado, por_instancia, memoria);
+            resultados[i].makespan = calcularCoste(resultados[i].solucion);
+            resultados[i].segundos =
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+        }
+    };
+    grupo.ejecutar(trabajar);
+    return resultados;
+}
+
+//--------------------------------
+// Lectura de instancias desde fichero
+//--------------------------------
+/*
+  Dos formatos; un fichero puede contener cualquier número de instancias.
+  - Texto: por instancia, el número de máquinas N, el de tareas n y las n
+    duraciones, separados por espacios o saltos de línea. '#' comenta hasta
+    el final de la línea. El ejemplo de 'main' sería "4 34  25 22 19 ...".
+  - Binario: por instancia, una cabecera de tres int32 (MAGIA_BINARIO, N, n)
+    y las n duraciones en int32, todo en little-endian. Como todos los campos
+    son de 4 bytes, el fichero mapeado se lee directamente como int32.
+  El fichero se mapea en memoria (en Windows se lee de una vez) y se analiza
+  sobre ese búfer sin copias ni reservas por línea: solo se reserva el vector
+  de duraciones de cada instancia, con su tamaño exacto.
+ */
+constexpr std::int32_t MAGIA_BINARIO = 0x31534D50; // "PMS1"
+
+// Contenido de un fichero completo, mapeado en memoria si se puede.
+struct ArchivoMapeado {
+    const char* datos = nullptr;
+    std::size_t tamano = 0;
+#if defined(_WIN32)
+    std::vector<char> copia;
+#endif
+
+    ArchivoMapeado() = default;
+    ArchivoMapeado(const ArchivoMapeado&) = delete;
+    ArchivoMapeado& operator=(const ArchivoMapeado&) = delete;
+
+    bool abrir(const char* ruta) {
+#if defined(_WIN32)
+        std::FILE* f = std::fopen(ruta, "rb");
+        if (!f) return false;
+        std::fseek(f, 0, SEEK_END);
+        long bytes = std::ftell(f);
+        std::fseek(f, 0, SEEK_SET);
+        copia.resize(bytes > 0 ? static_cast<std::size_t>(bytes) : 0);
+        bool ok = std::fread(copia.data(), 1, copia.size(), f) == copia.size();
+        std::fclose(f);
+        datos = copia.data();
+        tamano = copia.size();
+        return ok;
+#else
+        int fd = ::open(ruta, O_RDONLY);
+        if (fd < 0) return false;
+        struct stat info;
+        if (::fstat(fd, &info) != 0) {
+            ::close(fd);
+            return false;
+        }
+        tamano = static_cast<std::size_t>(info.st_size);
+        if (tamano > 0) {
+            void* p = ::mmap(nullptr, tamano, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) {
+                ::close(fd);
+                tamano = 0;
+                return false;
+            }
+            ::madvise(p, tamano, MADV_SEQUENTIAL);
+            datos = static_cast<const char*>(p);
+        }
+        ::close(fd); // el mapeo sigue siendo válido sin el descriptor
+        return true;
+#endif
+    }
+
+    ~ArchivoMapeado() {
+#if !defined(_WIN32)
+        if (datos) ::munmap(const_cast<char*>(datos), tamano);
+#endif
+    }
+};
+
+// Analizador de enteros no negativos sobre [p, fin), saltando espacios y comentarios.
+struct LectorTexto {
+    const char* p;
+    const char* fin;
+
+    void saltarBlancos() {
+        while (p < fin) {
+            if (*p == '#') {
+                while (p < fin && *p != '\n') ++p;
+            } else if (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r') {
+                ++p;
+            } else {
+                return;
+            }
+        }
+    }
+
+    bool terminado() {
+        saltarBlancos();
+        return p == fin;
+    }
+
+    bool leerEntero(int& valor) {
+        saltarBlancos();
+        if (p == fin || *p < '0' || *p > '9') return false;
+        long long v = 0;
+        while (p < fin && *p >= '0' && *p <= '9') {
+            v = v * 10 + (*p++ - '0');
+            if (v > std::numeric_limits<int>::max()) return false;
+        }
+        valor = static_cast<int>(v);
+        return true;
+    }
+};
+
+/*
+  Comprobaciones comunes a los dos formatos, una vez leídas las duraciones.
+  N solo puede pasar de n (las máquinas sobrantes quedan vacías) hasta
+  MAX_MAQUINAS, para que un N absurdo no reserve millones de máquinas. Las
+  cargas son 'int' y INT_MAX es el makespan de "sin solución"; la media de
+  carga, además, redondea sumando N - 1. Por eso Σp + N tiene que quedar por
+  debajo de INT_MAX.
+ */
+bool validarInstanciaLote(const InstanciaLote& inst, std::size_t numero, std::string& error) {
+    const int n = static_cast<int>(inst.tiempos.size());
+    if (inst.num_maquinas > std::max(n, MAX_MAQUINAS)) {
+        error = "demasiadas máquinas (" + std::to_string(inst.num_maquinas) + " para " + std::to_string(n) +
+                " tareas) en la instancia " + std::to_string(numero);
+        return false;
+    }
+    long long suma = 0;
+    for (int t : inst.tiempos) suma += t;
+    if (suma + inst.num_maquinas >= std::numeric_limits<int>::max()) {
+        error = "la suma de duraciones es demasiado grande en la instancia " + std::to_string(numero);
+        return false;
+    }
+    return true;
+}
+
+bool leerInstanciasTexto(const char* datos, std::size_t tamano, std::vector<InstanciaLote>& lote,
+                         std::string& error) {
+    LectorTexto lector{datos, datos + tamano};
+    while (!lector.terminado()) {
+        InstanciaLote inst;
+        int n;
+        if (!lector.leerEntero(inst.num_maquinas) || !lector.leerEntero(n) || inst.num_maquinas < 1) {
+            error = "cabecera 'N n' no válida en la instancia " + std::to_string(lote.size() + 1);
+            return false;
+        }
+        // Cada duración ocupa al menos un separador y una cifra: un 'n' mayor no
+        // cabe en lo que queda del fichero y no se reserva.
+        if (n < 0 || static_cast<std::size_t>(n) > static_cast<std::size_t>(lector.fin - lector.p) / 2) {
+            error = "faltan duraciones en la instancia " + std::to_string(lote.size() + 1);
+            return false;
+        }
+        inst.tiempos.resize(n);
+        for (int& t : inst.tiempos) {
+            if (!lector.leerEntero(t)) {
+                error = "faltan duraciones en la instancia " + std::to_string(lote.size() + 1);
+                return false;
+            }
+        }
+        if (!validarInstanciaLote(inst, lote.size() + 1, error)) return false;
+        lote.push_back(std::move(inst));
+    }
+    return true;
+}
+
+bool leerInstanciasBinario(const char* datos, std::size_t tamano, std::vector<InstanciaLote>& lote,
+                           std::string& error) {
+    std::size_t pos = 0;
+    auto leer32 = [&](std::int32_t& v) {
+        if (tamano - pos < sizeof(v)) return false;
+        std::memcpy(&v, datos + pos, sizeof(v));
+        pos += sizeof(v);
+        return true;
+    };
+    while (pos < tamano) {
+        std::int32_t magia, N, n;
+        if (!leer32(magia) || magia != MAGIA_BINARIO || !leer32(N) || !leer32(n) || N < 1 || n < 0 ||
+            (tamano - pos) / sizeof(std::int32_t) < static_cast<std::size_t>(n)) {
+            error = "registro binario no válido en la instancia " + std::to_string(lote.size() + 1);
+            return false;
+        }
+        InstanciaLote inst;
+        inst.num_maquinas = N;
+        inst.tiempos.resize(n);
+        std::memcpy(inst.tiempos.data(), datos + pos, static_cast<std::size_t>(n) * sizeof(std::int32_t));
+        pos += static_cast<std::size_t>(n) * sizeof(std::int32_t);
+        if (std::any_of(inst.tiempos.begin(), inst.tiempos.end(), [](int t) { return t < 0; })) {
+            error = "duración negativa en la instancia " + std::to_string(lote.size() + 1);
+            return false;
+        }
+        if (!validarInstanciaLote(inst, lote.size() + 1, error)) return false;
+        lote.push_back(std::move(inst));
+    }
+    return true;
+}
+
+// Lee todas las instancias de 'ruta'; el formato se reconoce por los primeros bytes.
+bool leerInstancias(const char* ruta, std::vector<InstanciaLote>& lote, std::string& error) {
+    ArchivoMapeado archivo;
+    if (!archivo.abrir(ruta)) {
+        error = std::string("no se puede abrir ") + ruta;
+        return false;
+    }
+    std::int32_t magia = 0;
+    if (archivo.tamano >= sizeof(magia)) std::memcpy(&magia, archivo.datos, sizeof(magia));
+    if (magia == MAGIA_BINARIO) return leerInstanciasBinario(archivo.datos, archivo.tamano, lote, error);
+    return leerInstanciasTexto(archivo.datos, archivo.tamano, lote, error);
+}
+
+// Escribe 'lote' en el formato binario, con una sola llamada a fwrite por instancia.
+bool escribirInstanciasBinario(const char* ruta, const std::vector<InstanciaLote>& lote) {
+    std::FILE* f = std::fopen(ruta, "wb");
+    if (!f) return false;
+    bool ok = true;
+    std::vector<std::int32_t> registro;
+    for (const auto& inst : lote) {
+        registro.assign({MAGIA_BINARIO, inst.num_maquinas, static_cast<std::int32_t>(inst.tiempos.size())});
+        registro.insert(registro.end(), inst.tiempos.begin(), inst.tiempos.end());
+        ok = ok && std::fwrite(registro.data(), sizeof(std::int32_t), registro.size(), f) == registro.size();
+    }
+    return std::fclose(f) == 0 && ok;
+}
+
+//--------------------------------
+// Escritura de resultados
+//--------------------------------
+/*
+  Salida de las soluciones para procesarlas después, sin texto por líneas ni
+  mapas intermedios. Cada instancia se aplana primero en un 'ResultadoPlano'
+  y se escribe en 'EscritorResultados::bufer', que va al fichero con una sola
+  llamada a fwrite. Dos formatos:
+  - JSON Lines: un objeto por línea, con las listas por tarea y por máquina
+    como vectores paralelos:
+    {"instancia":1,"makespan":..,"cota_inferior":..,"id_maquina":[..],
+     "carga":[..],"id_tarea":[..],"maquina":[..],"inicio":[..],
+     "estadisticas":{..}}
+    'maquina' es el id de la máquina de cada tarea, en el orden de 'id_tarea'.
+  - Binario, little-endian y sin relleno, por instancia:
+    int32 MAGIA_RESULTADO, N, n, makespan, cota_inferior;
+    int64 expandidos, generados, duplicados, reaperturas, pico_abierta, bytes;
+    float64 segundos;
+    N × int32 (id de máquina, carga); n × int32 (id de tarea, id de máquina, inicio).
+  Las tareas de cada máquina se ejecutan seguidas, en el orden en que se
+  asignaron, desde la carga inicial de la máquina.
+ */
+constexpr std::int32_t MAGIA_RESULTADO = 0x31524D50; // "PMR1"
+
+enum class FormatoResultados { JSONLineas, Binario };
+
+// Solución en vectores planos, por posición de la tarea en el 'Estado::T'
+// inicial y de la máquina en 'Estado::M'.
+struct ResultadoPlano {
+    std::vector<int> maquina_de; // posición de máquina de cada tarea
+    std::vector<int> inicio;     // instante de inicio de cada tarea
+    std::vector<int> carga;      // carga final de cada máquina
+    std::vector<int> primera;    // tareas de la máquina j: secuencia[primera[j] .. primera[j + 1])
+    std::vector<int> secuencia;  // tareas en orden de ejecución, agrupadas por máquina
+    int makespan = 0;
+    int cota_inferior = 0;
+};
+
+/*
+  Aplana 'solucion', una solución completa de 'estado_inicial'. Los ids se
+  traducen a posiciones con vectores ordenados (id, posición) y búsqueda
+  binaria. Devuelve false si alguna asignación no corresponde a una tarea
+  pendiente y una máquina de 'estado_inicial'.
+ */
+bool aplanarResultado(const Estado& estado_inicial, const Estado& solucion, ResultadoPlano& r) {
+    const int M = static_cast<int>(estado_inicial.M.size());
+    const int n = static_cast<int>(estado_inicial.T.size());
+    auto posiciones = [](const auto& elementos) {
+        std::vector<std::pair<int, int>> v;
+        v.reserve(elementos.size());
+        for (std::size_t i = 0; i < elementos.size(); ++i) v.push_back({elementos[i].id, static_cast<int>(i)});
+        std::sort(v.begin(), v.end());
+        return v;
+    };
+    auto buscar = [](const std::vector<std::pair<int, int>>& v, int id) {
+        auto it = std::lower_bound(v.begin(), v.end(), std::make_pair(id, std::numeric_limits<int>::min()));
+        return it != v.end() && it->first == id ? it->second : -1;
+    };
+    const auto pos_tarea = posiciones(estado_inicial.T);
+    const auto pos_maquina = posiciones(estado_inicial.M);
+
+    r.maquina_de.assign(n, -1);
+    r.inicio.assign(n, 0);
+    r.carga.resize(M);
+    for (int j = 0; j < M; ++j) r.carga[j] = estado_inicial.M[j].tiempo_ocupado;
+    r.primera.assign(M + 1, 0);
+    r.secuencia.resize(n);
+    std::vector<int> orden; // tareas en el orden de las asignaciones
+    orden.reserve(n);
+    for (std::size_t a = estado_inicial.Asignaciones.size(); a < solucion.Asignaciones.size(); ++a) {
+        const int t = buscar(pos_tarea, solucion.Asignaciones[a].tarea_id);
+        const int j = buscar(pos_maquina, solucion.Asignaciones[a].maquina_id);
+        if (t < 0 || j < 0 || r.maquina_de[t] >= 0) return false;
+        r.maquina_de[t] = j;
+        r.inicio[t] = r.carga[j];
+        r.carga[j] += duracionEn(estado_inicial, estado_inicial.T[t], j);
+        orden.push_back(t);
+        ++r.primera[j + 1];
+    }
+    if (static_cast<int>(orden.size()) != n) return false;
+    for (int j = 0; j < M; ++j) r.primera[j + 1] += r.primera[j];
+    std::vector<int> siguiente(r.primera.begin(), r.primera.end() - 1);
+    for (int t : orden) r.secuencia[siguiente[r.maquina_de[t]]++] = t;
+
+    r.makespan = M ? *std::max_element(r.carga.begin(), r.carga.end()) : 0;
+    InstanciaModelo im;
+    prepararModelo(estado_inicial, im);
+    r.cota_inferior = std::min(r.makespan, cotaInferiorModelo(im));
+    return true;
+}
+
+// Añade el entero x en decimal al final de 's'.
+inline void anadirEntero(std::string& s, long long x) {
+    char cifras[24];
+    auto fin = std::to_chars(cifras, cifras + sizeof(cifras), x).ptr;
+    s.append(cifras, fin);
+}
+
+// Añade los bytes de 'valor' (little-endian en las plataformas soportadas) al final de 's'.
+template <typename T>
+inline void anadirBinario(std::string& s, T valor) {
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, &valor, sizeof(T));
+    s.append(bytes, sizeof(T));
+}
+
+struct EscritorResultados {
+    std::FILE* f = nullptr;
+    FormatoResultados formato = FormatoResultados::JSONLineas;
+    std::string bufer;     // registro de la instancia en curso; se reutiliza
+    ResultadoPlano plano;  // ídem
+    long long instancias = 0;
+    bool ok = true;
+
+    EscritorResultados() = default;
+    EscritorResultados(const EscritorResultados&) = delete;
+    EscritorResultados& operator=(const EscritorResultados&) = delete;
+    ~EscritorResultados() { cerrar(); }
+
+    bool abrir(const char* ruta, FormatoResultados formato_) {
+        formato = formato_;
+        f = std::fopen(ruta, formato == FormatoResultados::Binario ? "wb" : "w");
+        if (f) std::setvbuf(f, nullptr, _IONBF, 0); // el búfer es 'bufer'
+        ok = f != nullptr;
+        return ok;
+    }
+
+    // Añade la solución de una instancia. Devuelve false si no es válida o no se puede escribir.
+    bool escribir(const Estado& estado_inicial, const Estado& solucion, const EstadisticasBusqueda& estadisticas) {
+        if (!f || !aplanarResultado(estado_inicial, solucion, plano)) return false;
+        bufer.clear();
+        if (formato == FormatoResultados::Binario) registroBinario(estado_inicial, estadisticas);
+        else registroJSON(estado_inicial, estadisticas);
+        ++instancias;
+        ok = ok && std::fwrite(bufer.data(), 1, bufer.size(), f) == bufer.size();
+        return ok;
+    }
+
+    bool cerrar() {
+        if (f) ok = std::fclose(f) == 0 && ok;
+        f = nullptr;
+        return ok;
+    }
+
+private:
+    void registroJSON(const Estado& estado_inicial, const EstadisticasBusqueda& estadisticas) {
+        const std::size_t M = estado_inicial.M.size(), n = estado_inicial.T.size();
+        auto lista = [&](const char* clave, std::size_t tamano, auto&& valor) {
+            bufer += ",\"";
+            bufer += clave;
+            bufer += "\":[";
+            for (std::size_t i = 0; i < tamano; ++i) {
+                if (i) bufer += ',';
+                anadirEntero(bufer, valor(i));
+            }
+            bufer += ']';
+        };
+        bufer.reserve(64 + 8 * (2 * M + 3 * n));
+        bufer += "{\"instancia\":";
+        anadirEntero(bufer, instancias + 1);
+        bufer += ",\"makespan\":";
+        anadirEntero(bufer, plano.makespan);
+        bufer += ",\"cota_inferior\":";
+        anadirEntero(bufer, plano.cota_inferior);
+        lista("id_maquina", M, [&](std::size_t j) { return estado_inicial.M[j].id; });
+        lista("carga", M, [&](std::size_t j) { return plano.carga[j]; });
+        lista("id_tarea", n, [&](std::size_t t) { return estado_inicial.T[t].id; });
+        lista("maquina", n, [&](std::size_t t) { return estado_inicial.M[plano.maquina_de[t]].id; });
+        lista("inicio", n, [&](std::size_t t) { return plano.inicio[t]; });
+        bufer += ",\"estadisticas\":";
+        bufer += estadisticas.json();
+        bufer += "}\n";
+    }
+
+    void registroBinario(const Estado& estado_inicial, const EstadisticasBusqueda& estadisticas) {
+        const std::size_t M = estado_inicial.M.size(), n = estado_inicial.T.size();
+        bufer.reserve(5 * 4 + 7 * 8 + 8 * M + 12 * n);
+        for (std::int32_t v : {MAGIA_RESULTADO, static_cast<std::int32_t>(M), static_cast<std::int32_t>(n),
+                               static_cast<std::int32_t>(plano.makespan),
+                               static_cast<std::int32_t>(plano.cota_inferior)})
+            anadirBinario(bufer, v);
+        for (long long v : {estadisticas.expandidos, estadisticas.generados, estadisticas.duplicados,
+                            estadisticas.reaperturas, static_cast<long long>(estadisticas.pico_abierta),
+                            static_cast<long long>(estadisticas.bytes)})
+            anadirBinario(bufer, static_cast<std::int64_t>(v));
+        anadirBinario(bufer, estadisticas.segundos);
+        for (std::size_t j = 0; j < M; ++j) {
+            anadirBinario(bufer, static_cast<std::int32_t>(estado_inicial.M[j].id));
+            anadirBinario(bufer, static_cast<std::int32_t>(plano.carga[j]));
+        }
+        for (std::size_t t = 0; t < n; ++t) {
+            anadirBinario(bufer, static_cast<std::int32_t>(estado_inicial.T[t].id));
+            anadirBinario(bufer, static_cast<std::int32_t>(estado_inicial.M[plano.maquina_de[t]].id));
+            anadirBinario(bufer, static_cast<std::int32_t>(plano.inicio[t]));
+        }
+    }
+};
+
+//--------------------------------
+// Banco de pruebas
+//--------------------------------
+/*
+  Familias de instancias de P||Cmax generadas con semillas fijas. El
+  generador es splitmix64 ('mezclar64') y no las distribuciones de <random>,
+  cuyo resultado cambia entre bibliotecas estándar: la misma semilla da la
+  misma instancia en cualquier compilador.
+  - u1_100:  p ~ U[1, 100]
+  - u20_50:  p ~ U[20, 50]
+  - franca:  no uniforme al estilo de França et al.: el 98 % de las tareas
+             en U[90, 100] y el 2 % en U[1, 20]
+  - ejemplo: los dos listados de tareas de 'main', con 4 máquinas
+  Cada motor se ejecuta 'repeticiones' veces por instancia y se da la
+  mediana del tiempo. La salida es una tabla separada por tabuladores con
+  una fila por (instancia, motor); todas las columnas salvo 'mediana_s' son
+  deterministas con un hilo, así que dos ejecuciones se pueden comparar con
+  diff quitando esa columna.
+ */
+const std::vector<int> TIEMPOS_EJEMPLO_34 = {25, 22, 19, 17, 12, 12, 11, 10, 10, 9, 9, 8, 8, 7, 5, 5, 5,
+                                             5, 4, 4, 4, 4, 3, 3, 3, 3, 2, 2, 2, 2, 1, 1, 1, 1};
+const std::vector<int> TIEMPOS_EJEMPLO_41 = {25, 22, 19, 17, 12, 12, 11, 10, 10, 9, 9, 8, 8, 7,
+                                             5, 5, 5, 5, 4, 4, 4, 4, 3, 3, 3, 3, 2, 2,
+                                             2, 2, 1, 1, 1, 1, 2, 2, 3, 2, 5, 4, 5};
+
+struct GeneradorInstancias {
+    std::uint64_t estado;
+
+    explicit GeneradorInstancias(std::uint64_t semilla) : estado(semilla) {}
+
+    // Entero en [lo, hi].
+    int uniforme(int lo, int hi) {
+        estado += 0x9E3779B97F4A7C15ull;
+        return lo + static_cast<int>(mezclar64(estado) % static_cast<std::uint64_t>(hi - lo + 1));
+    }
+};
+
+struct InstanciaBanco {
+    std::string familia;
+    int semilla;
+    InstanciaLote datos;
+};
+
+std::vector<InstanciaBanco> generarBanco() {
+    std::vector<InstanciaBanco> banco;
+    banco.push_back({"ejemplo", 0, {4, TIEMPOS_EJEMPLO_34}});
+    banco.push_back({"ejemplo", 1, {4, TIEMPOS_EJEMPLO_41}});
+    const std::pair<int, int> tamanos[] = {{3, 12}, {5, 15}, {8, 20}}; // (máquinas, tareas)
+    const char* familias[] = {"u1_100", "u20_50", "franca"};
+    for (int f = 0; f < 3; ++f) {
+        for (auto [M, n] : tamanos) {
+            for (int semilla = 1; semilla <= 3; ++semilla) {
+                // La semilla del generador depende de (familia, M, n, semilla), no del orden de generación.
+                GeneradorInstancias gen((static_cast<std::uint64_t>(f) << 48) | (static_cast<std::uint64_t>(M) << 32) |
+                                        (static_cast<std::uint64_t>(n) << 16) | static_cast<std::uint64_t>(semilla));
+                InstanciaLote inst{M, {}};
+                for (int i = 0; i < n; ++i) {
+                    if (f == 0) inst.tiempos.push_back(gen.uniforme(1, 100));
+                    else if (f == 1) inst.tiempos.push_back(gen.uniforme(20, 50));
+                    else inst.tiempos.push_back(gen.uniforme(1, 100) <= 98 ? gen.uniforme(90, 100) : gen.uniforme(1, 20));
+                }
+                banco.push_back({familias[f], semilla, std::move(inst)});
+            }
+        }
+    }
+    return banco;
+}
+
+struct MotorBanco {
+    const char* nombre;
+    std::function<Estado(const Estado&, const OpcionesBusqueda&)> ejecutar;
+};
+
+std::vector<MotorBanco> motoresBanco() {
+    return {
+        {"A_estrella", [](const Estado& e, const OpcionesBusqueda& o) { return A_estrella(e, o); }},
+        {"IDA_estrella", [](const Estado& e, const OpcionesBusqueda& o) { return IDA_estrella(e, o); }},
+        {"HDA_estrella", [](const Estado& e, const OpcionesBusqueda& o) { return HDA_estrella(e, o); }},
+        {"A_estrella_lotes", [](const Estado& e, const OpcionesBusqueda& o) { return A_estrella_lotes(e, o); }},
+        {"prog_dinamica", [](const Estado& e, const OpcionesBusqueda& o) { return resolverPorBinPacking(e, o); }},
+        {"ramificacion_poda", [](const Estado& e, const OpcionesBusqueda& o) { return ramificacionYPoda(e, o); }},
+        {"anytime_1s", [](const Estado& e, const OpcionesBusqueda& o) { return A_estrella_anytime(e, 1.0, nullptr, o); }},
+        {"haz", [](const Estado& e, const OpcionesBusqueda& o) { return busquedaHaz(e, o); }},
+    };
+}
+
+// Ejecuta el banco completo y escribe la tabla en 'os'. Devuelve el número
+// de ejecuciones cuya solución no asigna todas las tareas.
+int ejecutarBanco(std::ostream& os, int repeticiones, int hilos) {
+    os << "familia\tmaquinas\ttareas\tsemilla\tmotor\tmakespan\tcota_inferior\tgap_pct\tmediana_s\texpandidos\n";
+    int fallos = 0;
+    for (const InstanciaBanco& caso : generarBanco()) {
+        Estado estado = estadoDesdeTiempos(caso.datos.num_maquinas, caso.datos.tiempos);
+        PreparacionBusqueda prep;
+        prepararBusqueda(estado, OpcionesBusqueda{}, prep);
+        const int cota = prep.f_inicial;
+        for (const MotorBanco& motor : motoresBanco()) {
+            std::vector<double> tiempos;
+            EstadisticasBusqueda estadisticas;
+            int makespan = 0;
+            for (int r = 0; r < repeticiones; ++r) {
+                OpcionesBusqueda opciones;
+                opciones.hilos = hilos;
+                opciones.estadisticas = &estadisticas;
+                auto inicio = std::chrono::steady_clock::now();
+                Estado solucion = motor.ejecutar(estado, opciones);
+                tiempos.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count());
+                makespan = calcularCoste(solucion);
+                if (!solucion.T.empty()) ++fallos;
+            }
+            std::nth_element(tiempos.begin(), tiempos.begin() + tiempos.size() / 2, tiempos.end());
+            double gap = makespan > 0 ? 100.0 * (makespan - cota) / makespan : 0;
+            char gap_texto[32];
+            std::snprintf(gap_texto, sizeof(gap_texto), "%.2f", gap);
+            os << caso.familia << '\t' << caso.datos.num_maquinas << '\t' << caso.datos.tiempos.size() << '\t'
+               << caso.semilla << '\t' << motor.nombre << '\t' << makespan << '\t' << cota << '\t' << gap_texto
+               << '\t' << tiempos[tiempos.size() / 2] << '\t' << estadisticas.expandidos << '\n';
+        }
+    }
+    return fallos;
+}
+
+//--------------------------------
+// Programa principal
+//--------------------------------
+/*
+  Uso: programa [--anytime SEGUNDOS] [--lns SEGUNDOS] [--instancias FICHERO] [--json FICHERO]
+                [--banco REPETICIONES] [--externo DIRECTORIO] [--cartera] [--traza FICHERO]
+                [--resultados FICHERO | --resultados-bin FICHERO]
+  Sin argumentos se busca el óptimo con 'resolver' (A* o programación
+  dinámica, según la instancia). Con --anytime se usa el modo anytime y se
+  muestra cada solución mejorada hasta agotar el plazo.
+  Con --lns se mejora la solución constructiva con la búsqueda de grandes
+  vecindarios (ver "Búsqueda de grandes vecindarios (LNS)") durante los
+  segundos indicados, mostrando también cada mejora.
+  Con --instancias se leen las instancias del fichero (ver "Lectura de
+  instancias desde fichero") en lugar de usar las de este código. Si hay
+  más de una se resuelven con 'resolverLote' y se muestra una línea por
+  instancia.
+  Con --json se escriben además las estadísticas de la búsqueda (un objeto,
+  o una lista con uno por instancia) en el fichero indicado.
+  Con --banco se ejecuta el banco de pruebas (ver "Banco de pruebas") con un
+  hilo y se escribe la tabla por la salida estándar.
+  Con --externo se usa A* con las listas abierta y cerrada en ficheros del
+  directorio indicado (ver "A* en memoria externa").
+  Con --cartera compiten en paralelo varios motores exactos y se queda el
+  primero en demostrar el óptimo (ver "Cartera de motores").
+  Con --traza se escribe en el fichero indicado la traza de la búsqueda en
+  formato de eventos de Chrome (ver "Perfilado por fases"); requiere
+  compilar con -DPERFIL_FASES=1.
+  Con --resultados se escribe la solución de cada instancia en el fichero
+  indicado en JSON Lines, y con --resultados-bin en el formato binario (ver
+  "Escritura de resultados"); no poder abrirlo o escribirlo es un error.
+ */
+int main(int argc, char* argv[]) {
+    double presupuesto_anytime = -1;
+    double presupuesto_lns = -1;
+    const char* ruta_instancias = nullptr;
+    const char* ruta_json = nullptr;
+    int repeticiones_banco = 0;
+    const char* directorio_externo = nullptr;
+    bool cartera = false;
+    const char* ruta_traza = nullptr;
+    const char* ruta_resultados = nullptr;
+    FormatoResultados formato_resultados = FormatoResultados::JSONLineas;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--anytime" && i + 1 < argc) {
+            presupuesto_anytime = std::atof(argv[++i]);
+        } else if (arg == "--lns" && i + 1 < argc) {
+            presupuesto_lns = std::atof(argv[++i]);
+        } else if (arg == "--instancias" && i + 1 < argc) {
+            ruta_instancias = argv[++i];
+        } else if (arg == "--json" && i + 1 < argc) {
+            ruta_json = argv[++i];
+        } else if (arg == "--banco" && i + 1 < argc && std::atoi(argv[i + 1]) > 0) {
+            repeticiones_banco = std::atoi(argv[++i]);
+        } else if (arg == "--externo" && i + 1 < argc) {
+            directorio_externo = argv[++i];
+        } else if (arg == "--cartera") {
+            cartera = true;
+        } else if (arg == "--traza" && i + 1 < argc) {
+            ruta_traza = argv[++i];
+        } else if ((arg == "--resultados" || arg == "--resultados-bin") && i + 1 < argc) {
+            ruta_resultados = argv[++i];
+            formato_resultados = arg == "--resultados" ? FormatoResultados::JSONLineas : FormatoResultados::Binario;
+        } else {
+            std::cerr << "Uso: " << argv[0]
+                      << " [--anytime SEGUNDOS] [--lns SEGUNDOS] [--instancias FICHERO] [--json FICHERO] [--banco REPETICIONES]"
+                         " [--externo DIRECTORIO] [--cartera] [--traza FICHERO]"
+                         " [--resultados FICHERO | --resultados-bin FICHERO]\n";
+            return 1;
+        }
+    }
+    if (repeticiones_banco > 0) return ejecutarBanco(std::cout, repeticiones_banco, 1) == 0 ? 0 : 1;
+    if (ruta_traza) {
+        if (!PERFIL_FASES) std::cerr << "Aviso: compilado sin -DPERFIL_FASES=1, la traza sale vacia\n";
+        activarTraza(true);
+    }
+
+    // Escribe 'contenido' en 'ruta', si se ha pedido.
+    auto exportar = [](const char* ruta, const std::string& contenido) {
+        if (!ruta) return true;
+        std::FILE* f = std::fopen(ruta, "w");
+        bool ok = f && std::fputs(contenido.c_str(), f) >= 0 && std::fputc('\n', f) != EOF;
+        if (f) ok = std::fclose(f) == 0 && ok;
+        if (!ok) std::cerr << "No se puede escribir " << ruta << "\n";
+        return ok;
+    };
+    auto exportarJSON = [&](const std::string& contenido) { return exportar(ruta_json, contenido); };
+    EscritorResultados resultados_fichero;
+    if (ruta_resultados && !resultados_fichero.abrir(ruta_resultados, formato_resultados)) {
+        std::cerr << "No se puede escribir " << ruta_resultados << "\n";
+        return 1;
+    }
+    // Guarda la solución de una instancia en el fichero de resultados, si se ha pedido.
+    auto guardarResultado = [&](const Estado& inicial, const Estado& solucion, const EstadisticasBusqueda& e) {
+        if (!ruta_resultados || resultados_fichero.escribir(inicial, solucion, e)) return true;
+        std::cerr << "Error escribiendo " << ruta_resultados << "\n";
+        return false;
+    };
+
+    int N = 4 ; // EDITAR SI SE QUIERE CAMBIAR EL NUMERO DE MÁQUINAS
+
+    // EDITAR SI SE QUIERE CAMBIAR EL LISTADO DE TAREAS A ASIGNAR
+    std::vector<int> tiempos = {25, 22, 19, 17, 12, 12, 11, 10, 10, 9, 9, 8, 8, 7, 5, 5, 5, 5, 4, 4, 4, 4, 3, 3, 3, 3, 2, 2, 2, 2, 1, 1, 1, 1};
+  //std::vector<int> tiempos = {25, 22, 19, 17, 12, 12, 11, 10, 10, 9, 9, 8, 8, 7, 5, 5, 5, 5, 4, 4, 4, 4, 3, 3, 3, 3, 2, 2, 2, 2, 1, 1, 1, 1, 2, 2, 3, 2, 5, 4, 5}; // DESCOMENTAR SI SE QUIERE PROBAR ESTE EJEMPLO
+
+    if (ruta_instancias) {
+        std::vector<InstanciaLote> lote;
+        std::string error;
+        if (!leerInstancias(ruta_instancias, lote, error)) {
+            std::cerr << "Error leyendo " << ruta_instancias << ": " << error << "\n";
+            return 1;
+        }
+        if (lote.empty()) {
+            std::cerr << ruta_instancias << " no contiene instancias\n";
+            return 1;
+        }
+        if (lote.size() > 1) {
+            auto inicio = std::chrono::steady_clock::now();
+            std::vector<ResultadoLote> resultados = resolverLote(lote);
+            double total = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+            std::string json = "[";
+            bool guardados = true;
+            for (std::size_t k = 0; k < resultados.size(); ++k) {
+                guardados = guardados && guardarResultado(estadoDesdeTiempos(lote[k].num_maquinas, lote[k].tiempos),
+                                                          resultados[k].solucion, resultados[k].estadisticas);
+                std::cout << "Instancia " << k + 1 << ": " << lote[k].num_maquinas << " maquinas, "
+                          << lote[k].tiempos.size() << " tareas, makespan " << resultados[k].makespan
+                          << " (" << resultados[k].segundos << " s, "
+                          << resultados[k].estadisticas.expandidos << " nodos expandidos)\n";
+                json += (k ? "," : "") + resultados[k].estadisticas.json();
+            }
+            std::cout << "Tiempo total del lote (s): " << total << " s\n";
+            guardados = resultados_fichero.cerrar() && guardados;
+            return exportarJSON(json + "]") && guardados ? 0 : 1;
+        }
+        N = lote[0].num_maquinas;
+        tiempos = lote[0].tiempos;
+    }
+
+    Estado estado;
+    for (int i = 1; i <= N; i++) {
+        estado.M.push_back({i});
+    }
+
+    for (int i = 0; i < (int)tiempos.size(); ++i) {
+        estado.T.push_back({i + 1, tiempos[i]});
+    }
+
+    // SE EJECUTA EL ALGORITMO DE BÚSQUEDA
+    auto start = std::chrono::steady_clock::now();
+    Estado solucion;
+    EstadisticasBusqueda estadisticas;
+    OpcionesBusqueda opciones;
+    opciones.estadisticas = &estadisticas;
+    std::string error_busqueda;
+    if (directorio_externo) {
+        opciones.motor = Motor::AEstrella;
+        opciones.directorio_externo = directorio_externo;
+        opciones.error = &error_busqueda;
+    }
+    auto informarMejora = [&](const Estado&, int makespan, int cota_inferior) {
+        double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "Mejora: makespan " << makespan << " (cota inferior " << cota_inferior
+                  << ", gap " << 100.0 * (makespan - cota_inferior) / makespan << "%) a los "
+                  << t << " s\n";
+    };
+    if (presupuesto_anytime >= 0) {
+        solucion = A_estrella_anytime(estado, presupuesto_anytime, informarMejora, opciones);
+    } else if (presupuesto_lns >= 0) {
+        solucion = busquedaVecindarios(estado, presupuesto_lns, informarMejora, opciones);
+    } else if (cartera) {
+        solucion = resolverCartera(estado, opciones);
+    } else {
+        solucion = resolver(estado, opciones);
+    }
+    auto end = std::chrono::steady_clock::now();
+    if (!error_busqueda.empty()) {
+        std::cerr << error_busqueda << "\n";
+        return 1;
+    }
+
+
+    //----------------Presntación de los resultaods----------------
+    // Todo el informe se compone en 'informe' a partir de la solución aplanada
+    // y se escribe de una vez.
+    ResultadoPlano plano;
+    bool completa = aplanarResultado(estado, solucion, plano);
+    std::string informe = "Asignaciones finales:\n";
+    for (const auto& a : solucion.Asignaciones) {
+        informe += "Tarea ";
+        anadirEntero(informe, a.tarea_id);
+        informe += " -> Maquina ";
+        anadirEntero(informe, a.maquina_id);
+        informe += '\n';
+    }
+
+    informe += "\nTiempo ocupado de maquinas:\n";
+    for (const auto& m : solucion.M) {
+        informe += "Maquina ";
+        anadirEntero(informe, m.id);
+        informe += ": ";
+        anadirEntero(informe, m.tiempo_ocupado);
+        informe += '\n';
+    }
+
+    informe += "Makespan final: ";
+    anadirEntero(informe, calcularCoste(solucion));
+    informe += '\n';
+
+    if (completa) {
+        informe += "\nAsignaciones por maquina:\n";
+        for (std::size_t j = 0; j < estado.M.size(); ++j) {
+            informe += "Maquina ";
+            anadirEntero(informe, estado.M[j].id);
+            informe += ":\n";
+
+            // Mostrar IDs de tareas y sus tiempos, en orden de ejecución
+            for (int fila = 0; fila < 2; ++fila) {
+                informe += fila == 0 ? "  Tareas (IDs): " : "\n  Tiempos:      ";
+                for (int k = plano.primera[j]; k < plano.primera[j + 1]; ++k) {
+                    const Tarea& tarea = estado.T[plano.secuencia[k]];
+                    if (k != plano.primera[j]) informe += ", ";
+                    anadirEntero(informe, fila == 0 ? tarea.id : duracionEn(estado, tarea, j));
+                }
+            }
+            informe += '\n';
+        }
     }
+    std::cout.write(informe.data(), static_cast<std::streamsize>(informe.size()));
 
 
     double duration_s = std::chrono::duration<double>(end - start).count(); //
     std::cout << "Tiempo de busqueda (s):  " << duration_s << " s\n"; //
-    return 0;
+#if ESTADISTICAS_BUSQUEDA
+    std::cout << "\nEstadisticas de la busqueda:\n";
+    estadisticas.imprimir(std::cout);
+#endif
+#if PERFIL_FASES
+    std::cout << "\n";
+    imprimirPerfil(std::cout);
+#endif
+    bool ok = exportar(ruta_traza, trazaChrome());
+    ok = guardarResultado(estado, solucion, estadisticas) && ok;
+    ok = resultados_fichero.cerrar() && ok;
+    return exportarJSON(estadisticas.json()) && ok ? 0 : 1;
 }